@@ -0,0 +1,116 @@
+// AppSearchBench.cpp
+// Tiempo por pulsación de AppSearch::query sobre 5.000 aplicaciones
+// sintéticas, y reservas de memoria hechas durante las consultas (se
+// cuentan sustituyendo el operator new global).
+//
+//   make bench && ./build/bench/app_search
+#include "../src/app_launcher/AppSearch.hpp"
+#include "../src/app_launcher/Frecency.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+
+constexpr int ENTRIES = 5000;
+constexpr size_t MAX_RESULTS = 50;     // Como AppLauncher::MAX_RESULTS
+constexpr int RUNS = 51;
+
+// Generador determinista: mismas aplicaciones en cada ejecución
+uint32_t next_random(uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+std::string make_word(uint32_t& state, int syllables) {
+    static const char* parts[] = {"me", "si", "nal", "net", "do", "ra", "mon", "de", "chi", "fi",
+                                  "re", "fox", "ter", "mi", "ka", "lk", "vis", "or", "con", "fig"};
+    std::string word;
+    for (int i = 0; i < syllables; ++i) {
+        word += parts[next_random(state) % 20];
+    }
+    return word;
+}
+
+// Árbol XDG con ENTRIES archivos .desktop
+void write_applications(const std::filesystem::path& dir) {
+    std::filesystem::create_directories(dir);
+    static const char* generic[] = {"Editor", "Navegador web", "Terminal", "Visor de imágenes", "Calculadora"};
+    uint32_t state = 42;
+    for (int i = 0; i < ENTRIES; ++i) {
+        std::string name = make_word(state, 2 + next_random(state) % 3);
+        name[0] = static_cast<char>(name[0] - 'a' + 'A');
+        std::ofstream file(dir / ("app" + std::to_string(i) + ".desktop"));
+        file << "[Desktop Entry]\nType=Application\n"
+             << "Name=" << name << "\n"
+             << "GenericName=" << generic[next_random(state) % 5] << "\n"
+             << "Keywords=" << make_word(state, 3) << ";" << make_word(state, 2) << ";\n"
+             << "Exec=/usr/bin/" << make_word(state, 2) << i << " %U\n"
+             << "Categories=System;\n";
+    }
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+int main() {
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "entorno-app-search-bench";
+    std::filesystem::remove_all(root);
+    write_applications(root / "data" / "applications");
+    setenv("XDG_DATA_HOME", (root / "data").c_str(), 1);
+    setenv("XDG_DATA_DIRS", (root / "none").c_str(), 1);
+
+    auto index = AppIndex::scan();
+    Frecency frecency((root / "frecency.json").string());
+    AppSearch search;
+    search.rebuild(*index, frecency);
+
+    // Escritura letra a letra, con erratas y consultas de una sola letra
+    const char* typed[] = {"configuracion", "firefox", "terminal", "mesinalnet", "fiorefox",
+                           "edi", "m", "vis", "kalkulat", "nvegador"};
+    std::vector<double> times_us;
+    uint64_t query_allocations = 0;
+    size_t keystrokes = 0;
+    for (const char* text : typed) {
+        std::string_view full(text);
+        for (size_t length = 1; length <= full.size(); ++length, ++keystrokes) {
+            for (int run = 0; run < RUNS; ++run) {
+                uint64_t before = allocations.load(std::memory_order_relaxed);
+                search.query(full.substr(0, length), MAX_RESULTS);
+                query_allocations += allocations.load(std::memory_order_relaxed) - before;
+                times_us.push_back(search.get_last_query_ns() / 1000.0);
+            }
+        }
+    }
+    std::sort(times_us.begin(), times_us.end());
+    std::filesystem::remove_all(root);
+
+    std::printf("Aplicaciones: %zu, pulsaciones: %zu (x%d)\n", search.size(), keystrokes, RUNS);
+    std::printf("por pulsación: mediana %.0f us, p99 %.0f us, máx %.0f us\n",
+                times_us[times_us.size() / 2], times_us[times_us.size() * 99 / 100], times_us.back());
+    std::printf("reservas durante las consultas: %llu\n", static_cast<unsigned long long>(query_allocations));
+    return query_allocations == 0 && times_us[times_us.size() * 99 / 100] < 1000 ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+// CSSParserBench.cpp
+// Compara CSSParser::parse y compile/render con la sustitución por std::regex
+// anterior sobre una hoja de más de 100 KB.
+//
+//   make bench && ./build/bench/css_parser
+#include "../src/utils/CSSParser.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Implementación anterior (regex + find/replace sobre el resultado)
+std::string regex_parse(const std::string& css, const nlohmann::json& variables) {
+    std::string result = css;
+    std::regex var_regex(R"(var\((--[a-zA-Z0-9_-]+)\))");
+    std::smatch matches;
+    
+    std::string::const_iterator search_start = css.cbegin();
+    while (std::regex_search(search_start, css.cend(), matches, var_regex)) {
+        std::string full_match = matches[0];
+        std::string var_name = matches[1];
+        std::string replacement;
+        if (variables.contains(var_name.substr(2))) {
+            replacement = variables[var_name.substr(2)].get<std::string>();
+        } else {
+            replacement = "inherit";
+        }
+        size_t pos = result.find(full_match);
+        if (pos != std::string::npos) {
+            result.replace(pos, full_match.length(), replacement);
+        }
+        search_start = matches.suffix().first;
+    }
+    return result;
+}
+
+template <typename Function>
+double median_ms(int runs, Function function) {
+    std::vector<double> times;
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+} // namespace
+
+int main() {
+    nlohmann::json variables;
+    for (int i = 0; i < 64; ++i) {
+        variables["color-" + std::to_string(i)] = "#" + std::to_string(100000 + i * 1111);
+    }
+    
+    // ~2.500 reglas con tres referencias cada una
+    std::string css;
+    for (int i = 0; css.size() < 120 * 1024; ++i) {
+        css += ".component-" + std::to_string(i) + " .child > button:hover {\n"
+               "    background-color: var(--color-" + std::to_string(i % 64) + ");\n"
+               "    color: var(--color-" + std::to_string((i + 7) % 64) + ");\n"
+               "    border: 1px solid var(--missing-" + std::to_string(i % 5) + ");\n"
+               "    padding: 4px 8px;\n}\n";
+    }
+    
+    CSSParser parser;
+    if (parser.parse(css, variables) != regex_parse(css, variables)) {
+        std::fprintf(stderr, "Las dos implementaciones no coinciden\n");
+        return 1;
+    }
+    
+    std::string sink;
+    double regex_ms = median_ms(5, [&]() { sink = regex_parse(css, variables); });
+    double parse_ms = median_ms(51, [&]() { sink = parser.parse(css, variables); });
+    CSSTemplate tmpl = parser.compile(css);
+    double render_ms = median_ms(51, [&]() { sink = parser.render(tmpl, variables); });
+    
+    std::printf("Hoja: %zu bytes\n", css.size());
+    std::printf("regex:           %9.3f ms\n", regex_ms);
+    std::printf("parse:           %9.3f ms (x%.0f)\n", parse_ms, regex_ms / parse_ms);
+    std::printf("compile+render:  %9.3f ms por render (x%.0f)\n", render_ms, regex_ms / render_ms);
+    return 0;
+}
@@ -0,0 +1,67 @@
+// EventDispatchBench.cpp
+// Coste de un disparo en el bus tipado (EventId + varios suscriptores)
+// frente al mapa anterior por nombre con un único callback.
+//
+//   make bench && ./build/bench/event_dispatch
+#include "../src/core/EventManager.hpp"
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+
+namespace {
+
+constexpr int ITERATIONS = 5000000;
+
+// Implementación anterior: std::map por nombre, dos búsquedas por disparo
+std::map<std::string, std::function<void()>> old_events;
+
+void old_trigger(const std::string& name) {
+    if (old_events.find(name) != old_events.end()) {
+        old_events[name]();
+    }
+}
+
+template <typename Function>
+double ns_per_call(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        function(i);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+}
+
+} // namespace
+
+int main() {
+    volatile uint64_t sink = 0;
+    
+    // Unos cuantos eventos más, como en el escritorio
+    const char* names[] = {"desktop_right_click", "wallpaper_loaded", "theme_built", "icon_loaded",
+                           "apps_indexed", "system_sample", "menu_provider_ready", "app_selected"};
+    for (const char* name : names) {
+        old_events[name] = [&sink]() { sink = sink + 1; };
+    }
+    const std::string old_name = "system_sample";
+    double old_ns = ns_per_call([&](int) { old_trigger(old_name); });
+    
+    auto& events = EventManager::get_instance();
+    for (const char* name : names) {
+        events.intern(name);
+    }
+    auto sample = events.event<int>("system_sample");
+    auto single = events.subscribe(sample, [&sink](const int& value) { sink = sink + value; });
+    double one_ns = ns_per_call([&](int i) { events.emit(sample, i); });
+    
+    EventManager::Subscription extra[3] = {
+        events.subscribe(sample, [&sink](const int& value) { sink = sink + value; }),
+        events.subscribe(sample, [&sink](const int& value) { sink = sink ^ value; }),
+        events.subscribe(sample, [&sink](const int& value) { sink = sink - value; }),
+    };
+    double four_ns = ns_per_call([&](int i) { events.emit(sample, i); });
+    
+    std::printf("map por nombre (1 callback):  %6.1f ns/disparo\n", old_ns);
+    std::printf("EventId, 1 suscriptor:        %6.1f ns/disparo (x%.1f)\n", one_ns, old_ns / one_ns);
+    std::printf("EventId, 4 suscriptores:      %6.1f ns/disparo\n", four_ns);
+    return 0;
+}
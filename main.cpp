@@ -1,7 +1,7 @@
 // main.cpp
 #include "src/core/CoreSystem.hpp"
+#include "src/core/Tracer.hpp"
 #include <gtkmm/application.h>
-#include <iostream>
 
 int main(int argc, char* argv[]) {
     auto app = Gtk::Application::create("org.mi.entorno");
@@ -11,12 +11,13 @@ int main(int argc, char* argv[]) {
         core.start(app);
     });
 
-    // Prueba de recarga después de 5 segundos
-    Glib::signal_timeout().connect_seconds([&]() {
-        std::cout << "Recargando tema..." << std::endl;
-        core.reload_theme();
-        return true; // Solo se ejecuta una vez, con false se ejecuta una vez, con true cada 5 segundos
-    }, 5);
+    // Sin recarga periódica: ThemeLoader recarga el tema cuando cambian los archivos
 
-    return app->run(argc, argv);
+    int status = app->run(argc, argv);
+    
+    // Con ENTORNO_TRACE, las trazas se vuelcan también al salir
+    if (Tracer::enabled()) {
+        Tracer::get_instance().dump();
+    }
+    return status;
 }
\ No newline at end of file
@@ -0,0 +1,732 @@
+// AppIndex.cpp
+#include "AppIndex.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <thread>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char INDEX_MAGIC[8] = {'E', 'N', 'T', 'A', 'P', 'I', 'X', '\0'};
+constexpr uint32_t INDEX_VERSION = 1;
+
+// Disposición del archivo: cabecera, directorios, entradas y cadenas.
+// Todas las secciones empiezan alineadas a 8 bytes.
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_size;            // sizeof(Entry) al guardarlo
+    uint32_t dir_count;
+    uint32_t entry_count;
+    uint32_t environment;           // Cadena con idioma, escritorios y directorios
+    uint32_t reserved;
+    uint64_t dirs_offset;
+    uint64_t entries_offset;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+    uint64_t file_size;
+};
+
+struct FileDir {
+    int64_t mtime_ns;
+    uint32_t path;
+    uint32_t reserved;
+};
+
+struct Mapping {
+    void* address;
+    size_t length;
+};
+
+// Resultado de un archivo antes de internar las cadenas
+struct ParsedEntry {
+    std::string desktop_id;
+    std::string path;
+    std::string name, generic_name, comment, exec, icon, categories, keywords;
+    bool terminal = false;
+};
+
+struct DesktopFile {
+    std::string desktop_id;
+    std::string path;
+};
+
+int64_t dir_mtime_ns(const std::string& path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+        return 0;
+    }
+    return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+}
+
+uint64_t align8(uint64_t value) {
+    return (value + 7) & ~uint64_t(7);
+}
+
+bool write_all(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Variantes del idioma para las claves traducidas (Name[es_ES], Name[es]...),
+// de la más específica a la más general, según la especificación XDG
+std::vector<std::string> locale_variants() {
+    const char* env = nullptr;
+    for (const char* name : {"LC_ALL", "LC_MESSAGES", "LANG"}) {
+        env = std::getenv(name);
+        if (env && *env) {
+            break;
+        }
+    }
+    if (!env || !*env) {
+        return {};
+    }
+    
+    // lang_COUNTRY.ENCODING@MODIFIER
+    std::string locale = env;
+    std::string modifier;
+    size_t at = locale.find('@');
+    if (at != std::string::npos) {
+        modifier = locale.substr(at);
+        locale.erase(at);
+    }
+    size_t dot = locale.find('.');
+    if (dot != std::string::npos) {
+        locale.erase(dot);
+    }
+    if (locale == "C" || locale == "POSIX") {
+        return {};
+    }
+    
+    std::string lang = locale.substr(0, locale.find('_'));
+    std::vector<std::string> variants;
+    if (!modifier.empty() && locale != lang) variants.push_back(locale + modifier);
+    if (locale != lang) variants.push_back(locale);
+    if (!modifier.empty()) variants.push_back(lang + modifier);
+    variants.push_back(lang);
+    return variants;
+}
+
+// Escritorios actuales (XDG_CURRENT_DESKTOP, separados por ':')
+std::vector<std::string> current_desktops() {
+    std::vector<std::string> desktops;
+    const char* env = std::getenv("XDG_CURRENT_DESKTOP");
+    std::string_view value = env ? env : "";
+    while (!value.empty()) {
+        size_t sep = value.find(':');
+        desktops.emplace_back(value.substr(0, sep));
+        value = sep == std::string_view::npos ? std::string_view() : value.substr(sep + 1);
+    }
+    return desktops;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) text.remove_suffix(1);
+    return text;
+}
+
+// Secuencias de escape de los valores: \s \n \t \r \\ (y \; se mantiene en listas)
+std::string unescape(std::string_view value) {
+    std::string out;
+    out.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] != '\\' || i + 1 == value.size()) {
+            out.push_back(value[i]);
+            continue;
+        }
+        char next = value[++i];
+        switch (next) {
+            case 's': out.push_back(' '); break;
+            case 'n': out.push_back('\n'); break;
+            case 't': out.push_back('\t'); break;
+            case 'r': out.push_back('\r'); break;
+            case '\\': out.push_back('\\'); break;
+            default: out.push_back('\\'); out.push_back(next); break;
+        }
+    }
+    return out;
+}
+
+// ¿Alguno de los escritorios aparece en la lista "a;b;c;"?
+bool list_contains_any(std::string_view list, const std::vector<std::string>& names) {
+    while (!list.empty()) {
+        size_t sep = list.find(';');
+        std::string_view item = list.substr(0, sep);
+        for (const auto& name : names) {
+            if (item == name) {
+                return true;
+            }
+        }
+        list = sep == std::string_view::npos ? std::string_view() : list.substr(sep + 1);
+    }
+    return false;
+}
+
+bool read_file(const std::string& path, std::string& out) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    out.clear();
+    char buffer[8192];
+    ssize_t n;
+    while ((n = ::read(fd, buffer, sizeof(buffer))) > 0) {
+        out.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return n == 0;
+}
+
+// Analiza el grupo [Desktop Entry]. Devuelve false si la entrada no debe
+// mostrarse (no es una aplicación, está oculta o es de otro escritorio).
+bool parse_desktop_file(const std::string& content,
+                        const std::vector<std::string>& locales,
+                        const std::vector<std::string>& desktops,
+                        ParsedEntry& entry) {
+    // Rango de la traducción elegida por clave: menor es mejor
+    const size_t untranslated = locales.size();
+    size_t name_rank = SIZE_MAX, generic_rank = SIZE_MAX, comment_rank = SIZE_MAX, keywords_rank = SIZE_MAX;
+    bool in_main_group = false;
+    bool is_application = false;
+    std::string_view only_show_in, not_show_in;
+    
+    std::string_view text(content);
+    while (!text.empty()) {
+        size_t eol = text.find('\n');
+        std::string_view line = trim(text.substr(0, eol));
+        text = eol == std::string_view::npos ? std::string_view() : text.substr(eol + 1);
+        
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        if (line.front() == '[') {
+            // Solo interesa el grupo principal; las acciones vienen después
+            if (in_main_group) {
+                break;
+            }
+            in_main_group = line == "[Desktop Entry]";
+            continue;
+        }
+        if (!in_main_group) {
+            continue;
+        }
+        
+        size_t eq = line.find('=');
+        if (eq == std::string_view::npos) {
+            continue;
+        }
+        std::string_view key = trim(line.substr(0, eq));
+        std::string_view value = trim(line.substr(eq + 1));
+        
+        // Clave traducida: Name[es_ES]
+        size_t rank = untranslated;
+        size_t bracket = key.find('[');
+        if (bracket != std::string_view::npos) {
+            std::string_view locale = key.substr(bracket + 1);
+            if (locale.empty() || locale.back() != ']') {
+                continue;
+            }
+            locale.remove_suffix(1);
+            key = key.substr(0, bracket);
+            auto it = std::find(locales.begin(), locales.end(), locale);
+            if (it == locales.end()) {
+                continue;
+            }
+            rank = static_cast<size_t>(it - locales.begin());
+        }
+        
+        auto take_translated = [&](size_t& best, std::string& field) {
+            if (rank < best) {
+                best = rank;
+                field = unescape(value);
+            }
+        };
+        
+        if (key == "Name") {
+            take_translated(name_rank, entry.name);
+        } else if (key == "GenericName") {
+            take_translated(generic_rank, entry.generic_name);
+        } else if (key == "Comment") {
+            take_translated(comment_rank, entry.comment);
+        } else if (key == "Keywords") {
+            take_translated(keywords_rank, entry.keywords);
+        } else if (rank != untranslated) {
+            continue;   // Resto de claves: la traducción no aplica
+        } else if (key == "Type") {
+            is_application = value == "Application";
+        } else if (key == "Exec") {
+            entry.exec = unescape(value);
+        } else if (key == "Icon") {
+            entry.icon = unescape(value);
+        } else if (key == "Categories") {
+            entry.categories = std::string(value);
+        } else if (key == "Terminal") {
+            entry.terminal = value == "true";
+        } else if (key == "NoDisplay" || key == "Hidden") {
+            if (value == "true") {
+                return false;
+            }
+        } else if (key == "OnlyShowIn") {
+            only_show_in = value;
+        } else if (key == "NotShowIn") {
+            not_show_in = value;
+        }
+    }
+    
+    if (!is_application || entry.name.empty() || entry.exec.empty()) {
+        return false;
+    }
+    if (!only_show_in.empty() && !list_contains_any(only_show_in, desktops)) {
+        return false;
+    }
+    if (!not_show_in.empty() && list_contains_any(not_show_in, desktops)) {
+        return false;
+    }
+    return true;
+}
+
+// Lista los .desktop de todos los directorios. Un mismo identificador en
+// varios directorios se queda con el de mayor prioridad, aunque esté oculto.
+// La fecha de cada directorio se anota antes de leerlo: cualquier cambio
+// posterior deja una fecha distinta de la guardada
+std::vector<DesktopFile> collect_desktop_files(const std::vector<std::string>& dirs,
+                                               std::vector<AppIndex::DirStamp>& stamps) {
+    std::vector<DesktopFile> files;
+    std::unordered_set<std::string> seen_ids;
+    
+    for (const auto& dir : dirs) {
+        stamps.push_back({dir, dir_mtime_ns(dir)});
+        
+        std::error_code ec;
+        fs::recursive_directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec);
+        for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            const auto& path = it->path();
+            if (it->is_directory(ec)) {
+                stamps.push_back({path.string(), dir_mtime_ns(path.string())});
+                continue;
+            }
+            if (path.extension() != ".desktop" || !it->is_regular_file(ec)) {
+                continue;
+            }
+            
+            // Identificador: ruta relativa con '/' sustituida por '-'
+            std::string desktop_id = path.lexically_relative(dir).string();
+            std::replace(desktop_id.begin(), desktop_id.end(), '/', '-');
+            if (seen_ids.insert(desktop_id).second) {
+                files.push_back({std::move(desktop_id), path.string()});
+            }
+        }
+    }
+    return files;
+}
+
+bool load_desktop_file(const std::string& path,
+                       const std::vector<std::string>& locales,
+                       const std::vector<std::string>& desktops,
+                       ParsedEntry& entry, std::string& buffer) {
+    return read_file(path, buffer) && parse_desktop_file(buffer, locales, desktops, entry);
+}
+
+// Lo que cambia el resultado del análisis: un índice guardado con otro
+// idioma, escritorio o lista de directorios no sirve
+std::string environment_key(const std::vector<std::string>& locales,
+                            const std::vector<std::string>& desktops,
+                            const std::vector<std::string>& dirs) {
+    std::string key;
+    for (const auto* list : {&locales, &desktops, &dirs}) {
+        for (const auto& item : *list) {
+            key += item;
+            key += ';';
+        }
+        key += '|';
+    }
+    return key;
+}
+
+AppIndex::Entry intern_entry(StringPool& pool, const std::string& desktop_id,
+                             const std::string& path, const ParsedEntry& source) {
+    AppIndex::Entry entry;
+    entry.desktop_id = pool.intern(desktop_id);
+    entry.path = pool.intern(path);
+    entry.name = pool.intern(source.name);
+    entry.generic_name = pool.intern(source.generic_name);
+    entry.comment = pool.intern(source.comment);
+    entry.exec = pool.intern(source.exec);
+    entry.icon = pool.intern(source.icon);
+    entry.categories = pool.intern(source.categories);
+    entry.keywords = pool.intern(source.keywords);
+    entry.terminal = source.terminal ? 1 : 0;
+    return entry;
+}
+
+AppIndex::Entry copy_entry(StringPool& pool, const AppIndex& from, const AppIndex::Entry& source) {
+    AppIndex::Entry entry;
+    entry.desktop_id = pool.intern(from.str(source.desktop_id));
+    entry.path = pool.intern(from.str(source.path));
+    entry.name = pool.intern(from.str(source.name));
+    entry.generic_name = pool.intern(from.str(source.generic_name));
+    entry.comment = pool.intern(from.str(source.comment));
+    entry.exec = pool.intern(from.str(source.exec));
+    entry.icon = pool.intern(from.str(source.icon));
+    entry.categories = pool.intern(from.str(source.categories));
+    entry.keywords = pool.intern(from.str(source.keywords));
+    entry.terminal = source.terminal;
+    return entry;
+}
+
+} // namespace
+
+std::vector<std::string> AppIndex::application_dirs() {
+    std::vector<std::string> dirs;
+    
+    const char* data_home = std::getenv("XDG_DATA_HOME");
+    const char* home = std::getenv("HOME");
+    if (data_home && *data_home) {
+        dirs.push_back(std::string(data_home) + "/applications");
+    } else if (home && *home) {
+        dirs.push_back(std::string(home) + "/.local/share/applications");
+    }
+    
+    const char* data_dirs = std::getenv("XDG_DATA_DIRS");
+    std::string_view value = (data_dirs && *data_dirs) ? data_dirs : "/usr/local/share:/usr/share";
+    while (!value.empty()) {
+        size_t sep = value.find(':');
+        std::string_view dir = value.substr(0, sep);
+        if (!dir.empty()) {
+            std::string path = std::string(dir);
+            if (path.back() != '/') {
+                path.push_back('/');
+            }
+            path += "applications";
+            if (std::find(dirs.begin(), dirs.end(), path) == dirs.end()) {
+                dirs.push_back(std::move(path));
+            }
+        }
+        value = sep == std::string_view::npos ? std::string_view() : value.substr(sep + 1);
+    }
+    return dirs;
+}
+
+std::shared_ptr<const AppIndex> AppIndex::scan() {
+    auto start = std::chrono::steady_clock::now();
+    auto index = std::make_shared<AppIndex>();
+    
+    std::vector<DirStamp> stamps;
+    std::vector<DesktopFile> files = collect_desktop_files(application_dirs(), stamps);
+    const std::vector<std::string> locales = locale_variants();
+    const std::vector<std::string> desktops = current_desktops();
+    
+    // Reparto dinámico: cada hilo toma el siguiente archivo libre. El
+    // resultado de cada archivo va a su propia posición, sin bloqueos
+    std::vector<ParsedEntry> parsed(files.size());
+    std::vector<char> visible(files.size(), 0);
+    std::atomic<size_t> next{0};
+    
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned int>(std::min<size_t>(threads, std::max<size_t>(1, files.size() / 64)));
+    
+    auto parse_worker = [&]() {
+        std::string buffer;
+        for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < files.size();
+             i = next.fetch_add(1, std::memory_order_relaxed)) {
+            if (load_desktop_file(files[i].path, locales, desktops, parsed[i], buffer)) {
+                visible[i] = 1;
+            }
+        }
+    };
+    
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threads; ++t) {
+        workers.emplace_back(parse_worker);
+    }
+    parse_worker();     // El hilo que escanea también trabaja
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    
+    // Internar en orden: el índice no depende del reparto entre hilos
+    StringPool pool;
+    std::vector<Entry> entries;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (visible[i]) {
+            entries.push_back(intern_entry(pool, files[i].desktop_id, files[i].path, parsed[i]));
+        }
+    }
+    index->adopt(std::move(pool), std::move(entries));
+    index->dirs_ = std::move(stamps);
+    
+    index->stats_.files = files.size();
+    index->stats_.entries = index->entry_count_;
+    index->stats_.threads = threads;
+    index->stats_.elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return index;
+}
+
+std::shared_ptr<const AppIndex> AppIndex::patch(const std::vector<std::string>& changed_paths) const {
+    auto start = std::chrono::steady_clock::now();
+    auto index = std::make_shared<AppIndex>();
+    const std::vector<std::string> dirs = application_dirs();
+    
+    // Fechas antes de leer nada, igual que en scan()
+    std::vector<DirStamp> stamps = dirs_;
+    for (auto& stamp : stamps) {
+        stamp.mtime_ns = dir_mtime_ns(stamp.path);
+    }
+    
+    // Identificadores afectados y su ruta relativa al directorio
+    std::unordered_map<std::string, std::string> affected;
+    for (const auto& changed : changed_paths) {
+        fs::path path = fs::path(changed).lexically_normal();
+        if (path.extension() != ".desktop") {
+            continue;
+        }
+        for (const auto& dir : dirs) {
+            fs::path relative = path.lexically_relative(dir);
+            if (!relative.empty() && *relative.begin() != "..") {
+                std::string desktop_id = relative.string();
+                std::replace(desktop_id.begin(), desktop_id.end(), '/', '-');
+                affected.emplace(std::move(desktop_id), relative.string());
+                break;
+            }
+        }
+    }
+    
+    // Las entradas no afectadas se copian sin volver a analizarlas
+    StringPool pool;
+    std::vector<Entry> entries;
+    entries.reserve(entry_count_ + affected.size());
+    for (const auto& entry : this->entries()) {
+        if (affected.find(std::string(str(entry.desktop_id))) == affected.end()) {
+            entries.push_back(copy_entry(pool, *this, entry));
+        }
+    }
+    
+    // Cada identificador afectado toma el archivo de mayor prioridad que
+    // exista; si está oculto, oculta también a los de menor prioridad
+    const std::vector<std::string> locales = locale_variants();
+    const std::vector<std::string> desktops = current_desktops();
+    std::string buffer;
+    size_t parsed_files = 0;
+    for (const auto& [desktop_id, relative] : affected) {
+        for (const auto& dir : dirs) {
+            std::string candidate = dir + "/" + relative;
+            struct stat st;
+            if (::stat(candidate.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+                continue;
+            }
+            ParsedEntry parsed;
+            if (load_desktop_file(candidate, locales, desktops, parsed, buffer)) {
+                entries.push_back(intern_entry(pool, desktop_id, candidate, parsed));
+            }
+            parsed_files++;
+            break;
+        }
+    }
+    
+    index->adopt(std::move(pool), std::move(entries));
+    index->dirs_ = std::move(stamps);
+    index->stats_.files = parsed_files;
+    index->stats_.entries = index->entry_count_;
+    index->stats_.threads = 1;
+    index->stats_.elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return index;
+}
+
+std::shared_ptr<const AppIndex> AppIndex::load(const std::string& file_path) {
+    auto start = std::chrono::steady_clock::now();
+    
+    int fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return nullptr;
+    }
+    std::shared_ptr<void> mapping(new Mapping{address, size}, [](void* data) {
+        auto* mapping = static_cast<Mapping*>(data);
+        munmap(mapping->address, mapping->length);
+        delete mapping;
+    });
+    
+    const char* base = static_cast<const char*>(address);
+    const auto* header = reinterpret_cast<const FileHeader*>(base);
+    
+    // Cabecera y límites de cada sección
+    bool valid = std::memcmp(header->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 &&
+                 header->version == INDEX_VERSION &&
+                 header->entry_size == sizeof(Entry) &&
+                 header->file_size == size &&
+                 header->dirs_offset % 8 == 0 && header->entries_offset % 8 == 0 &&
+                 header->dirs_offset + uint64_t(header->dir_count) * sizeof(FileDir) <= size &&
+                 header->entries_offset + uint64_t(header->entry_count) * sizeof(Entry) <= size &&
+                 header->strings_size > 0 &&
+                 header->strings_offset + header->strings_size <= size &&
+                 base[header->strings_offset + header->strings_size - 1] == '\0';
+    if (!valid) {
+        return nullptr;
+    }
+    
+    const char* strings = base + header->strings_offset;
+    auto valid_id = [&](StringId id) { return id < header->strings_size; };
+    
+    // Otro idioma, escritorio o lista de directorios: hay que reanalizar
+    std::string environment = environment_key(locale_variants(), current_desktops(), application_dirs());
+    if (!valid_id(header->environment) || strings + header->environment != environment) {
+        return nullptr;
+    }
+    
+    // Un directorio con otra fecha tiene archivos nuevos, borrados o renombrados
+    auto index = std::make_shared<AppIndex>();
+    const auto* dirs = reinterpret_cast<const FileDir*>(base + header->dirs_offset);
+    for (uint32_t i = 0; i < header->dir_count; ++i) {
+        if (!valid_id(dirs[i].path)) {
+            return nullptr;
+        }
+        std::string path = strings + dirs[i].path;
+        if (dir_mtime_ns(path) != dirs[i].mtime_ns) {
+            return nullptr;
+        }
+        index->dirs_.push_back({std::move(path), dirs[i].mtime_ns});
+    }
+    
+    const auto* entries = reinterpret_cast<const Entry*>(base + header->entries_offset);
+    for (uint32_t i = 0; i < header->entry_count; ++i) {
+        const Entry& entry = entries[i];
+        for (StringId id : {entry.desktop_id, entry.name, entry.generic_name, entry.comment, entry.exec,
+                            entry.icon, entry.categories, entry.keywords, entry.path}) {
+            if (!valid_id(id)) {
+                return nullptr;
+            }
+        }
+    }
+    
+    index->mapping_ = std::move(mapping);
+    index->entries_ = entries;
+    index->entry_count_ = header->entry_count;
+    index->strings_ = strings;
+    index->strings_size_ = header->strings_size;
+    index->stats_.entries = header->entry_count;
+    index->stats_.elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return index;
+}
+
+bool AppIndex::save(const std::string& file_path) const {
+    // Las cadenas del índice van tal cual; detrás, las rutas de los
+    // directorios y la clave de entorno
+    std::string extra;
+    auto append_extra = [&](const std::string& text) {
+        StringId id = static_cast<StringId>(strings_size_ + extra.size());
+        extra.append(text);
+        extra.push_back('\0');
+        return id;
+    };
+    
+    std::vector<FileDir> dirs;
+    for (const auto& stamp : dirs_) {
+        dirs.push_back({stamp.mtime_ns, append_extra(stamp.path), 0});
+    }
+    
+    FileHeader header{};
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.entry_size = sizeof(Entry);
+    header.dir_count = static_cast<uint32_t>(dirs.size());
+    header.entry_count = static_cast<uint32_t>(entry_count_);
+    header.environment = append_extra(environment_key(locale_variants(), current_desktops(), application_dirs()));
+    header.dirs_offset = align8(sizeof(FileHeader));
+    header.entries_offset = align8(header.dirs_offset + dirs.size() * sizeof(FileDir));
+    header.strings_offset = align8(header.entries_offset + entry_count_ * sizeof(Entry));
+    header.strings_size = strings_size_ + extra.size();
+    header.file_size = header.strings_offset + header.strings_size;
+    
+    std::error_code ec;
+    fs::create_directories(fs::path(file_path).parent_path(), ec);
+    
+    // Escritura atómica: archivo temporal y rename
+    std::string temp_path = file_path + ".tmp." + std::to_string(::getpid());
+    int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    
+    const char padding[8] = {};
+    uint64_t position = 0;
+    auto write_at = [&](uint64_t offset, const void* data, size_t size) {
+        bool ok = write_all(fd, padding, offset - position) && write_all(fd, data, size);
+        position = offset + size;
+        return ok;
+    };
+    
+    bool ok = write_at(0, &header, sizeof(header)) &&
+              write_at(header.dirs_offset, dirs.data(), dirs.size() * sizeof(FileDir)) &&
+              write_at(header.entries_offset, entries_, entry_count_ * sizeof(Entry)) &&
+              write_at(header.strings_offset, strings_, strings_size_) &&
+              write_all(fd, extra.data(), extra.size());
+    ok = ::close(fd) == 0 && ok;
+    
+    if (!ok || ::rename(temp_path.c_str(), file_path.c_str()) != 0) {
+        ::unlink(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+void AppIndex::adopt(StringPool&& pool, std::vector<Entry>&& entries) {
+    pool_ = std::move(pool);
+    owned_entries_ = std::move(entries);
+    sort_entries();
+    owned_entries_.shrink_to_fit();
+    
+    entries_ = owned_entries_.data();
+    entry_count_ = owned_entries_.size();
+    strings_ = pool_.data();
+    strings_size_ = pool_.size_bytes();
+}
+
+void AppIndex::sort_entries() {
+    // Orden alfabético (sin distinguir mayúsculas) para mostrarlo tal cual
+    const StringPool& strings = pool_;
+    std::sort(owned_entries_.begin(), owned_entries_.end(), [&strings](const Entry& a, const Entry& b) {
+        std::string_view x = strings.get(a.name), y = strings.get(b.name);
+        return std::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end(), [](char c1, char c2) {
+            return std::tolower(static_cast<unsigned char>(c1)) < std::tolower(static_cast<unsigned char>(c2));
+        });
+    });
+}
+
+size_t AppIndex::memory_bytes() const {
+    return entry_count_ * sizeof(Entry) + strings_size_;
+}
@@ -0,0 +1,106 @@
+// AppIndex.hpp
+#pragma once
+#include "../utils/StringPool.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Índice de aplicaciones instaladas, construido a partir de los archivos
+// .desktop de ~/.local/share/applications y $XDG_DATA_DIRS/applications.
+// Es inmutable una vez construido: los textos están internados en un
+// StringPool y cada entrada solo guarda identificadores.
+//
+// El índice se guarda en disco en formato binario (save) y en el siguiente
+// inicio se mapea tal cual (load): las entradas y las cadenas se leen
+// directamente del archivo, sin volver a analizar ningún .desktop.
+class AppIndex {
+public:
+    using StringId = StringPool::Id;
+
+    // Se escribe tal cual en el archivo: solo tipos de tamaño fijo
+    struct Entry {
+        StringId desktop_id = StringPool::EMPTY;    // p. ej. "org.gnome.Terminal.desktop"
+        StringId name = StringPool::EMPTY;           // Ya traducido al idioma del usuario
+        StringId generic_name = StringPool::EMPTY;
+        StringId comment = StringPool::EMPTY;
+        StringId exec = StringPool::EMPTY;
+        StringId icon = StringPool::EMPTY;
+        StringId categories = StringPool::EMPTY;
+        StringId keywords = StringPool::EMPTY;
+        StringId path = StringPool::EMPTY;           // Archivo .desktop de origen
+        uint32_t terminal = 0;
+    };
+
+    // Vista de solo lectura sobre las entradas (memoria propia o mapeada)
+    class Entries {
+    public:
+        Entries(const Entry* data, size_t count) : data_(data), count_(count) {}
+        const Entry* begin() const { return data_; }
+        const Entry* end() const { return data_ + count_; }
+        const Entry& operator[](size_t i) const { return data_[i]; }
+        size_t size() const { return count_; }
+        bool empty() const { return count_ == 0; }
+    private:
+        const Entry* data_;
+        size_t count_;
+    };
+
+    // Directorio recorrido y su fecha de modificación al indexarlo
+    struct DirStamp {
+        std::string path;
+        int64_t mtime_ns = 0;       // 0 si no existía
+    };
+
+    struct ScanStats {
+        size_t files = 0;           // Archivos .desktop analizados
+        size_t entries = 0;         // Aplicaciones visibles
+        unsigned int threads = 0;
+        double elapsed_ms = 0;
+    };
+
+    // Recorre los directorios y analiza los archivos en paralelo, uno por
+    // núcleo. Es bloqueante: se llama desde un hilo de trabajo.
+    static std::shared_ptr<const AppIndex> scan();
+
+    // Mapea un índice guardado. Devuelve nulo si no existe, es de otra
+    // versión o entorno (idioma, escritorio, directorios) o si algún
+    // directorio cambió desde que se guardó.
+    static std::shared_ptr<const AppIndex> load(const std::string& file_path);
+    bool save(const std::string& file_path) const;
+
+    // Índice nuevo con solo los archivos indicados vueltos a analizar
+    // (añadidos, modificados o borrados); el resto se copia tal cual.
+    std::shared_ptr<const AppIndex> patch(const std::vector<std::string>& changed_paths) const;
+
+    // Directorios de aplicaciones en orden de prioridad (el usuario primero)
+    static std::vector<std::string> application_dirs();
+
+    Entries entries() const { return Entries(entries_, entry_count_); }
+    std::string_view str(StringId id) const { return std::string_view(strings_ + id); }
+    const std::vector<DirStamp>& get_dirs() const { return dirs_; }
+    const ScanStats& get_stats() const { return stats_; }
+    bool is_mapped() const { return mapping_ != nullptr; }
+
+    // Memoria ocupada por las entradas y las cadenas
+    size_t memory_bytes() const;
+
+private:
+    void adopt(StringPool&& pool, std::vector<Entry>&& entries);
+    void sort_entries();
+
+    // Índice construido en memoria
+    StringPool pool_;
+    std::vector<Entry> owned_entries_;
+
+    // Lo que se consulta: apunta a lo anterior o al archivo mapeado
+    const Entry* entries_ = nullptr;
+    size_t entry_count_ = 0;
+    const char* strings_ = "";
+    size_t strings_size_ = 1;
+    std::shared_ptr<void> mapping_;
+
+    std::vector<DirStamp> dirs_;
+    ScanStats stats_;
+};
@@ -0,0 +1,169 @@
+// AppIndexer.cpp
+#include "AppIndexer.hpp"
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+AppIndexer::AppIndexer()
+    : cache_path_(Glib::get_user_cache_dir() + "/entorno/apps.idx") {
+    
+    job_done_.open("app_index_job_done", [this](const JobResult& result) { on_job_done(result); });
+    
+    // Vigilar antes de leer el índice guardado: lo que cambie durante la
+    // carga llega como evento y se aplica después
+    for (const auto& dir : AppIndex::application_dirs()) {
+        watch_directory(dir);
+    }
+    start_job();
+}
+
+AppIndexer::~AppIndexer() {
+    settle_timer_.disconnect();
+    for (auto& [path, monitor] : monitors_) {
+        monitor->cancel();
+    }
+    monitors_.clear();
+    
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    // Un resultado aún en cola ya no encuentra suscriptor
+    job_done_.close();
+}
+
+std::shared_ptr<const AppIndex> AppIndexer::get_index() const {
+    return index_;
+}
+
+sigc::signal<void()>& AppIndexer::signal_updated() {
+    return signal_updated_;
+}
+
+void AppIndexer::start_job() {
+    if (busy_) {
+        return;
+    }
+    
+    // Sin índice todavía: carga inicial (los cambios pendientes se quedan
+    // para el siguiente trabajo)
+    JobKind kind = JobKind::Startup;
+    std::vector<std::string> paths;
+    if (index_) {
+        if (pending_full_) {
+            kind = JobKind::FullScan;
+        } else if (!pending_paths_.empty()) {
+            kind = JobKind::Patch;
+            paths.assign(pending_paths_.begin(), pending_paths_.end());
+        } else {
+            return;
+        }
+        pending_full_ = false;
+        pending_paths_.clear();
+    }
+    
+    auto base = index_;
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    busy_ = true;
+    
+    worker_ = std::thread([this, kind, base, paths]() {
+        std::shared_ptr<const AppIndex> result;
+        if (kind == JobKind::Startup) {
+            result = AppIndex::load(cache_path_);
+        }
+        if (!result) {
+            result = kind == JobKind::Patch ? base->patch(paths) : AppIndex::scan();
+            if (!result->save(cache_path_)) {
+                std::cerr << "No se pudo guardar el índice de aplicaciones en " << cache_path_ << std::endl;
+            }
+        }
+        job_done_.post(JobResult{kind, std::move(result)});
+    });
+}
+
+void AppIndexer::on_job_done(const JobResult& result) {
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    busy_ = false;
+    index_ = result.index;
+    
+    const auto& stats = index_->get_stats();
+    if (index_->is_mapped()) {
+        std::cout << "Índice de aplicaciones leído de caché: " << stats.entries << " entradas en "
+                  << stats.elapsed_ms << " ms" << std::endl;
+    } else if (result.kind == JobKind::Patch) {
+        std::cout << "Índice de aplicaciones actualizado: " << stats.files << " archivos en "
+                  << stats.elapsed_ms << " ms" << std::endl;
+    } else {
+        std::cout << "Índice de aplicaciones: " << stats.entries << " de " << stats.files
+                  << " archivos en " << stats.elapsed_ms << " ms (" << stats.threads << " hilos, "
+                  << index_->memory_bytes() / 1024 << " KiB)" << std::endl;
+    }
+    
+    // Subdirectorios que el índice recorrió (los raíz ya están vigilados)
+    for (const auto& dir : index_->get_dirs()) {
+        if (dir.mtime_ns != 0) {
+            watch_directory(dir.path);
+        }
+    }
+    
+    signal_updated_.emit();
+    start_job();
+}
+
+void AppIndexer::watch_directory(const std::string& path) {
+    if (monitors_.find(path) != monitors_.end() || !fs::is_directory(path)) {
+        return;
+    }
+    
+    try {
+        auto monitor = Gio::File::create_for_path(path)->monitor_directory();
+        if (!monitor) {
+            std::cerr << "Error: No se pudo crear monitor para " << path << std::endl;
+            return;
+        }
+        monitor->signal_changed().connect(sigc::mem_fun(*this, &AppIndexer::on_directory_changed));
+        monitors_[path] = monitor;
+    }
+    catch (const Glib::Error& e) {
+        std::cerr << "Error configurando monitor: " << e.what() << std::endl;
+    }
+}
+
+void AppIndexer::on_directory_changed(const Glib::RefPtr<Gio::File>& file,
+                                      const Glib::RefPtr<Gio::File>& /*other_file*/,
+                                      Gio::FileMonitor::Event event_type) {
+    if (event_type != Gio::FileMonitor::Event::CHANGED &&
+        event_type != Gio::FileMonitor::Event::CHANGES_DONE_HINT &&
+        event_type != Gio::FileMonitor::Event::CREATED &&
+        event_type != Gio::FileMonitor::Event::DELETED) {
+        return;
+    }
+    
+    std::string path = file->get_path();
+    if (fs::path(path).extension() == ".desktop") {
+        pending_paths_.insert(path);
+    } else if (monitors_.find(path) != monitors_.end() ||
+               (event_type == Gio::FileMonitor::Event::CREATED && fs::is_directory(path))) {
+        // Subdirectorio nuevo o borrado: sus archivos no llegan uno a uno
+        pending_full_ = true;
+    } else {
+        return;
+    }
+    
+    if (!settle_timer_.connected()) {
+        settle_timer_ = Glib::signal_timeout().connect(
+            sigc::mem_fun(*this, &AppIndexer::on_changes_settled),
+            SETTLE_MS, Glib::PRIORITY_DEFAULT_IDLE
+        );
+    }
+}
+
+bool AppIndexer::on_changes_settled() {
+    settle_timer_.disconnect();
+    start_job();
+    return false;
+}
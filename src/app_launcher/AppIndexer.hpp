@@ -0,0 +1,63 @@
+// AppIndexer.hpp
+#pragma once
+#include <gtkmm.h>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include "AppIndex.hpp"
+#include "../core/EventManager.hpp"
+
+// Mantiene al día el índice de aplicaciones. Al arrancar mapea el índice
+// guardado en disco y solo escanea si falta o está desactualizado. Después
+// vigila los directorios de aplicaciones y aplica cada cambio como un
+// parche sobre el índice publicado, sin reescanear todo.
+class AppIndexer {
+public:
+    AppIndexer();
+    ~AppIndexer();
+
+    // Nulo hasta que termina la carga inicial
+    std::shared_ptr<const AppIndex> get_index() const;
+
+    // Se emite en el hilo principal cada vez que se publica un índice nuevo
+    sigc::signal<void()>& signal_updated();
+
+    AppIndexer(const AppIndexer&) = delete;
+    AppIndexer& operator=(const AppIndexer&) = delete;
+
+private:
+    enum class JobKind { Startup, FullScan, Patch };
+
+    // Resultado del hilo de trabajo; llega por job_done_
+    struct JobResult {
+        JobKind kind;
+        std::shared_ptr<const AppIndex> index;
+    };
+
+    void start_job();
+    void on_job_done(const JobResult& result);
+    void watch_directory(const std::string& path);
+    void on_directory_changed(const Glib::RefPtr<Gio::File>& file,
+                              const Glib::RefPtr<Gio::File>& other_file,
+                              Gio::FileMonitor::Event event_type);
+    bool on_changes_settled();
+
+    std::string cache_path_;
+    std::shared_ptr<const AppIndex> index_;
+
+    // Un solo trabajo a la vez; los cambios que lleguen mientras tanto esperan
+    std::thread worker_;
+    bool busy_ = false;
+    bool pending_full_ = false;
+    std::set<std::string> pending_paths_;
+    WorkerResults<JobResult> job_done_;
+
+    // Un paquete instala o borra muchos archivos seguidos: se agrupan
+    static constexpr unsigned int SETTLE_MS = 250;
+    sigc::connection settle_timer_;
+    std::map<std::string, Glib::RefPtr<Gio::FileMonitor>> monitors_;
+
+    sigc::signal<void()> signal_updated_;
+};
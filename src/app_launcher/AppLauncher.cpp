@@ -1,72 +1,188 @@
 // AppLauncher.cpp
 #include "AppLauncher.hpp"
+#include "../utils/ProcessStats.hpp"
 #include <iostream>
 
-AppLauncher::AppLauncher() 
+namespace {
+
+// Widgets vivos bajo root, incluido él mismo
+size_t count_widgets(Gtk::Widget& root) {
+    size_t count = 1;
+    for (auto* child = root.get_first_child(); child; child = child->get_next_sibling()) {
+        count += count_widgets(*child);
+    }
+    return count;
+}
+
+} // namespace
+
+AppLauncher::AppLauncher(IconService& icon_service, AppSpawner& spawner) 
     : main_box(Gtk::Orientation::VERTICAL),
-      app1("Navegador"), app2("Editor de texto"), app3("Terminal") {
+      status_label("Cargando aplicaciones..."),
+      icon_service(icon_service),
+      frecency(Glib::get_user_data_dir() + "/entorno/frecency.json"),
+      spawner(spawner) {
     
     set_title("App Launcher");
-    get_style_context()->add_class("app-launcher");
+    add_css_class("app-launcher");
     set_decorated(false);
     set_resizable(false);
-    set_default_size(300, 200);
-
-    // Conectar señales y guardar conexiones
-    button_connections.push_back(
-        app1.signal_clicked().connect([this]() { launch_dummy_app("Navegador"); })
-    );
-    button_connections.push_back(
-        app2.signal_clicked().connect([this]() { launch_dummy_app("Editor"); })
-    );
-    button_connections.push_back(
-        app3.signal_clicked().connect([this]() { launch_dummy_app("Terminal"); })
-    );
-
-    main_box.append(app1);
-    main_box.append(app2);
-    main_box.append(app3);
+    set_default_size(300, 400);
+
+    search_entry.set_placeholder_text("Buscar aplicaciones");
+    search_entry.signal_search_changed().connect(sigc::mem_fun(*this, &AppLauncher::on_search_changed));
+    search_entry.signal_activate().connect(sigc::mem_fun(*this, &AppLauncher::on_search_activate));
+
+    setup_list();
+    scrolled.set_policy(Gtk::PolicyType::NEVER, Gtk::PolicyType::AUTOMATIC);
+    scrolled.set_vexpand(true);
+    scrolled.set_child(list_view);
+
+    main_box.append(search_entry);
+    main_box.append(status_label);
+    main_box.append(scrolled);
     set_child(main_box);
     hide();
+    
+    indexer.signal_updated().connect(sigc::mem_fun(*this, &AppLauncher::on_index_updated));
+    property_is_active().signal_changed().connect(sigc::mem_fun(*this, &AppLauncher::on_active_changed));
 }
 
 AppLauncher::~AppLauncher() {
-    // Desconectar todas las señales de botones
-    for (auto& conn : button_connections) {
-        conn.disconnect();
-    }
-    button_connections.clear();
-    
-    // Limpiar proveedor CSS
-    if (current_provider) {
-        auto context = get_style_context();
-        context->remove_provider(current_provider);
-        current_provider.reset();
-    }
+    // indexer cancela sus monitores y espera a su hilo de trabajo
+    launch_timeout.disconnect();
 }
 
-void AppLauncher::apply_theme(ThemeManager* theme) {
-    auto context = get_style_context();
+void AppLauncher::setup_list() {
+    result_model = AppResultModel::create();
+    row_factory = Gtk::SignalListItemFactory::create();
+    
+    // setup: una vez por fila reciclable; bind: cada vez que muestra otra entrada
+    row_factory->signal_setup().connect([](const Glib::RefPtr<Gtk::ListItem>& list_item) {
+        auto* row = Gtk::make_managed<Gtk::Box>(Gtk::Orientation::HORIZONTAL, 8);
+        auto* image = Gtk::make_managed<Gtk::Image>();
+        auto* label = Gtk::make_managed<Gtk::Label>();
+        label->set_xalign(0);
+        label->set_ellipsize(Pango::EllipsizeMode::END);
+        row->append(*image);
+        row->append(*label);
+        list_item->set_child(*row);
+    });
+    row_factory->signal_bind().connect([this](const Glib::RefPtr<Gtk::ListItem>& list_item) {
+        auto item = std::dynamic_pointer_cast<AppItem>(list_item->get_item());
+        auto* row = list_item->get_child();
+        if (!item || !row || !index) {
+            return;
+        }
+        auto* image = dynamic_cast<Gtk::Image*>(row->get_first_child());
+        auto* label = dynamic_cast<Gtk::Label*>(image ? image->get_next_sibling() : nullptr);
+        if (!image || !label) {
+            return;
+        }
+        
+        const auto& entry = index->entries()[item->get_entry()];
+        label->set_text(std::string(index->str(entry.name)));
+        // Marcador hasta que el icono llegue del hilo de trabajo
+        icon_service.load_into(*image, std::string(index->str(entry.icon)), ICON_SIZE);
+    });
     
-    if (current_provider) {
-        context->remove_provider(current_provider);
+    list_view.set_model(Gtk::NoSelection::create(result_model));
+    list_view.set_factory(row_factory);
+    list_view.set_single_click_activate(true);
+    list_view.signal_activate().connect([this](guint position) {
+        if (position < result_model->size()) {
+            launch_app(result_model->get_entry(position));
+        }
+    });
+}
+
+void AppLauncher::on_index_updated() {
+    index = indexer.get_index();
+    search.rebuild(*index, frecency);
+    result_model->reserve(search.size());
+    on_search_changed();
+}
+
+void AppLauncher::on_search_changed() {
+    if (!index) {
+        return;
     }
     
-    // Obtener proveedor específico para app-launcher
-    current_provider = theme->get_component_provider("app-launcher");
-    if (current_provider) {
-        context->add_provider(current_provider, GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+    // Sin texto se listan todas, las más usadas primero. El texto se lee sin
+    // copiarlo: consulta y modelo no reservan memoria por pulsación (la
+    // vista de GTK sí, al crear o reciclar filas)
+    std::string_view text = gtk_editable_get_text(GTK_EDITABLE(search_entry.gobj()));
+    size_t limit = text.empty() ? search.size() : MAX_RESULTS;
+    result_model->set_results(search.query(text, limit));
+    
+    bool empty = result_model->size() == 0;
+    status_label.set_visible(empty);
+    if (empty) {
+        status_label.set_text(index->entries().empty() ? "No se encontraron aplicaciones" : "Sin resultados");
+    }
+}
+
+void AppLauncher::on_search_activate() {
+    // Intro lanza el primer resultado
+    if (result_model->size() > 0) {
+        launch_app(result_model->get_entry(0));
     }
 }
 
 void AppLauncher::toggle_visibility() {
     if (get_visible()) {
-        hide();
+        finish_launch();
     } else {
+        search_entry.set_text("");
+        show_started_us = g_get_monotonic_time();
         show();
+        search_entry.grab_focus();
+        add_tick_callback(sigc::mem_fun(*this, &AppLauncher::on_first_frame));
     }
 }
 
-void AppLauncher::launch_dummy_app(const Glib::ustring& name) {
-    std::cout << "Simulando Lanzamiento de: " << name << std::endl;
-}
\ No newline at end of file
+bool AppLauncher::on_first_frame(const Glib::RefPtr<Gdk::FrameClock>& /*clock*/) {
+    double latency_ms = (g_get_monotonic_time() - show_started_us) / 1000.0;
+    std::cout << "Lanzador visible en " << latency_ms << " ms ("
+              << count_widgets(*this) << " widgets, "
+              << (index ? index->entries().size() : 0) << " aplicaciones, RSS "
+              << ProcessStats::rss_bytes() / (1024 * 1024) << " MiB)" << std::endl;
+    return false;   // Solo el primer frame
+}
+
+void AppLauncher::launch_app(uint32_t entry_index) {
+    int64_t click_us = g_get_monotonic_time();
+    if (!index || entry_index >= index->entries().size()) {
+        return;
+    }
+    const auto& entry = index->entries()[entry_index];
+    if (!spawner.launch(*index, entry, click_us)) {
+        return;
+    }
+    
+    std::string desktop_id(index->str(entry.desktop_id));
+    frecency.record(desktop_id);
+    search.set_frecency(entry_index, frecency.score(desktop_id));
+    
+    launch_pending = true;
+    launch_timeout.disconnect();
+    launch_timeout = Glib::signal_timeout().connect([this]() {
+        finish_launch();
+        return false;
+    }, FIRST_WINDOW_TIMEOUT_MS);
+}
+
+void AppLauncher::on_active_changed() {
+    // La ventana nueva recibe el foco al mapearse: es la mejor señal de
+    // "primera ventana" que tiene un cliente sin acceso al compositor
+    if (launch_pending && !is_active()) {
+        spawner.mark_first_window();
+        finish_launch();
+    }
+}
+
+void AppLauncher::finish_launch() {
+    launch_pending = false;
+    launch_timeout.disconnect();
+    hide();
+}
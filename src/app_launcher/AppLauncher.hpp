@@ -1,24 +1,61 @@
 // AppLauncher.hpp
 #pragma once
 #include <gtkmm.h>
-#include "../config/ThemeManager.hpp"
-#include <sigc++/connection.h> // Para conexiones de señales
+#include <memory>
+#include "AppIndexer.hpp"
+#include "AppResultModel.hpp"
+#include "AppSearch.hpp"
+#include "AppSpawner.hpp"
+#include "Frecency.hpp"
+#include "../core/IconService.hpp"
 
 class AppLauncher : public Gtk::Window {
 public:
-    AppLauncher();
+    AppLauncher(IconService& icon_service, AppSpawner& spawner);
     ~AppLauncher(); // Destructor añadido
     
     void toggle_visibility();
-    void apply_theme(ThemeManager* theme);
+
+    // Índice publicado; nulo mientras se carga
+    std::shared_ptr<const AppIndex> get_index() const { return index; }
 
 private:
+    // Resultados de una búsqueda con texto; sin texto se listan todas
+    static constexpr size_t MAX_RESULTS = 200;
+    static constexpr int ICON_SIZE = 24;
+    // Tiempo máximo esperando la ventana de la aplicación lanzada
+    static constexpr unsigned int FIRST_WINDOW_TIMEOUT_MS = 5000;
+
     Gtk::Box main_box;
-    Gtk::Button app1, app2, app3;
+    Gtk::SearchEntry search_entry;
+    Gtk::ScrolledWindow scrolled;
+    Gtk::Label status_label;
+    
+    // Lista virtualizada: solo existen filas para lo visible y se reciclan
+    Gtk::ListView list_view;
+    Glib::RefPtr<AppResultModel> result_model;
+    Glib::RefPtr<Gtk::SignalListItemFactory> row_factory;
+    
+    IconService& icon_service;
+    AppIndexer indexer;
+    std::shared_ptr<const AppIndex> index;
+    AppSearch search;
+    Frecency frecency;
+    AppSpawner& spawner;                // Compartido, propiedad de CoreSystem
+    
+    int64_t show_started_us = 0;
     
-    // Conexiones de señales para manejo seguro
-    std::vector<sigc::connection> button_connections;
+    // Tras lanzar, el lanzador sigue visible hasta que la ventana nueva le
+    // quita el foco (primera ventana) o vence el plazo
+    bool launch_pending = false;
+    sigc::connection launch_timeout;
     
-    void launch_dummy_app(const Glib::ustring& name);
-    Glib::RefPtr<Gtk::CssProvider> current_provider;
-};
\ No newline at end of file
+    void setup_list();
+    void on_index_updated();
+    void on_search_changed();
+    void on_search_activate();
+    bool on_first_frame(const Glib::RefPtr<Gdk::FrameClock>& clock);
+    void launch_app(uint32_t entry_index);
+    void on_active_changed();
+    void finish_launch();
+};
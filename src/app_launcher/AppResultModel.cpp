@@ -0,0 +1,32 @@
+// AppResultModel.cpp
+#include "AppResultModel.hpp"
+
+AppItem::AppItem(uint32_t entry)
+    : entry_(entry) {}
+
+Glib::RefPtr<AppItem> AppItem::create(uint32_t entry) {
+    return Glib::make_refptr_for_instance<AppItem>(new AppItem(entry));
+}
+
+AppResultModel::AppResultModel()
+    : Glib::ObjectBase(typeid(AppResultModel)), Glib::Object(), Gio::ListModel() {}
+
+Glib::RefPtr<AppResultModel> AppResultModel::create() {
+    return Glib::make_refptr_for_instance<AppResultModel>(new AppResultModel());
+}
+
+GType AppResultModel::get_item_type_vfunc() {
+    return Glib::Object::get_base_type();
+}
+
+guint AppResultModel::get_n_items_vfunc() {
+    return static_cast<guint>(entries_.size());
+}
+
+gpointer AppResultModel::get_item_vfunc(guint position) {
+    if (position >= entries_.size()) {
+        return nullptr;
+    }
+    // La vista recibe su propia referencia (transfer full)
+    return AppItem::create(entries_[position])->gobj_copy();
+}
@@ -0,0 +1,53 @@
+// AppResultModel.hpp
+#pragma once
+#include <giomm.h>
+#include <cstdint>
+#include <vector>
+
+// Elemento de la lista: solo la posición de la entrada en AppIndex. Los
+// crea el modelo bajo demanda, únicamente para las filas que se dibujan.
+class AppItem : public Glib::Object {
+public:
+    static Glib::RefPtr<AppItem> create(uint32_t entry);
+    uint32_t get_entry() const { return entry_; }
+
+protected:
+    explicit AppItem(uint32_t entry);
+
+private:
+    uint32_t entry_;
+};
+
+// Modelo (GListModel) sobre los resultados de la búsqueda. No guarda
+// objetos por fila: la lista solo pide los elementos visibles.
+class AppResultModel : public Glib::Object, public Gio::ListModel {
+public:
+    static Glib::RefPtr<AppResultModel> create();
+
+    // Sustituye todos los resultados y avisa a la vista
+    template<typename Results>
+    void set_results(const Results& results) {
+        guint removed = static_cast<guint>(entries_.size());
+        entries_.clear();
+        for (const auto& result : results) {
+            entries_.push_back(result.entry);
+        }
+        items_changed(0, removed, static_cast<guint>(entries_.size()));
+    }
+
+    uint32_t get_entry(guint position) const { return entries_[position]; }
+    size_t size() const { return entries_.size(); }
+
+    // Reserva para no crecer en cada búsqueda
+    void reserve(size_t count) { entries_.reserve(count); }
+
+protected:
+    AppResultModel();
+
+    GType get_item_type_vfunc() override;
+    guint get_n_items_vfunc() override;
+    gpointer get_item_vfunc(guint position) override;
+
+private:
+    std::vector<uint32_t> entries_;
+};
@@ -0,0 +1,309 @@
+// AppSearch.cpp
+#include "AppSearch.hpp"
+#include "Frecency.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// Minúsculas ASCII y vocales acentuadas del español (UTF-8 de 2 bytes,
+// prefijo 0xC3) pasadas a su letra base: "Configuración" -> "configuracion".
+// Escribe en out como mucho capacity bytes y devuelve cuántos escribió.
+size_t normalize(std::string_view text, char* out, size_t capacity) {
+    size_t length = 0;
+    for (size_t i = 0; i < text.size() && length < capacity; ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == 0xC3 && i + 1 < text.size()) {
+            unsigned char next = static_cast<unsigned char>(text[i + 1]) | 0x20;   // Mayúscula -> minúscula
+            char base = 0;
+            if (next >= 0xA0 && next <= 0xA5) base = 'a';
+            else if (next == 0xA7) base = 'c';
+            else if (next >= 0xA8 && next <= 0xAB) base = 'e';
+            else if (next >= 0xAC && next <= 0xAF) base = 'i';
+            else if (next == 0xB1) base = 'n';
+            else if (next >= 0xB2 && next <= 0xB6) base = 'o';
+            else if (next >= 0xB9 && next <= 0xBC) base = 'u';
+            if (base) {
+                out[length++] = base;
+                ++i;
+                continue;
+            }
+        }
+        out[length++] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : static_cast<char>(c);
+    }
+    return length;
+}
+
+void append_normalized(std::string& out, std::string_view text) {
+    size_t start = out.size();
+    out.resize(start + text.size());
+    out.resize(start + normalize(text, &out[start], text.size()));
+}
+
+bool is_separator(char c) {
+    return c == ' ' || c == ';' || c == '-' || c == '_' || c == '.' || c == '/';
+}
+
+uint32_t trigram_key(const char* p) {
+    return (uint32_t(static_cast<unsigned char>(p[0])) << 16) |
+           (uint32_t(static_cast<unsigned char>(p[1])) << 8) |
+           uint32_t(static_cast<unsigned char>(p[2]));
+}
+
+// Subsecuencia con bonificaciones al estilo de los selectores difusos:
+// letras seguidas, inicio de palabra y prefijo. Negativo si no aparece
+float fuzzy_score(std::string_view query, std::string_view text) {
+    if (query.size() > text.size()) {
+        return -1;
+    }
+    if (text.compare(0, query.size(), query) == 0) {
+        return query.size() == text.size() ? 200.0f : 150.0f + float(query.size());
+    }
+    
+    float score = 0;
+    size_t position = 0;
+    size_t previous = SIZE_MAX;
+    for (char wanted : query) {
+        while (position < text.size() && text[position] != wanted) {
+            ++position;
+        }
+        if (position == text.size()) {
+            return -1;
+        }
+        score += 10;
+        if (previous != SIZE_MAX && position == previous + 1) {
+            score += 15;
+        } else if (position == 0 || is_separator(text[position - 1])) {
+            score += 20;
+        } else if (previous != SIZE_MAX) {
+            score -= std::min<float>(float(position - previous - 1), 10.0f);
+        }
+        previous = position++;
+    }
+    return score;
+}
+
+// Bonificación por uso, creciente pero acotada
+float frecency_bonus(double frecency) {
+    return frecency > 0 ? static_cast<float>(25.0 * std::log1p(frecency / 50.0)) : 0.0f;
+}
+
+} // namespace
+
+void AppSearch::rebuild(const AppIndex& index, const Frecency& frecency) {
+    auto entries = index.entries();
+    
+    text_.clear();
+    entries_.clear();
+    words_.clear();
+    frecency_bonus_.clear();
+    entries_.reserve(entries.size());
+    frecency_bonus_.reserve(entries.size());
+    
+    std::vector<std::pair<uint32_t, uint32_t>> trigrams;   // (clave, entrada)
+    
+    for (uint32_t i = 0; i < entries.size(); ++i) {
+        const auto& entry = entries[i];
+        EntryText item;
+        
+        item.name_offset = static_cast<uint32_t>(text_.size());
+        append_normalized(text_, index.str(entry.name));
+        item.name_length = static_cast<uint32_t>(text_.size() - item.name_offset);
+        
+        item.extra_offset = static_cast<uint32_t>(text_.size());
+        append_normalized(text_, index.str(entry.keywords));
+        text_.push_back(' ');
+        append_normalized(text_, index.str(entry.generic_name));
+        text_.push_back(' ');
+        // Solo el nombre del ejecutable, sin ruta ni argumentos
+        std::string_view exec = index.str(entry.exec);
+        exec = exec.substr(0, exec.find(' '));
+        size_t slash = exec.rfind('/');
+        append_normalized(text_, slash == std::string_view::npos ? exec : exec.substr(slash + 1));
+        item.extra_length = static_cast<uint32_t>(text_.size() - item.extra_offset);
+        
+        entries_.push_back(item);
+        frecency_bonus_.push_back(frecency_bonus(frecency.score(std::string(index.str(entry.desktop_id)))));
+        
+        // Palabras para el índice de prefijos y trigramas de cada texto
+        for (auto [offset, length] : {std::pair{item.name_offset, item.name_length},
+                                      std::pair{item.extra_offset, item.extra_length}}) {
+            uint32_t word_start = offset;
+            for (uint32_t p = offset; p <= offset + length; ++p) {
+                if (p == offset + length || is_separator(text_[p])) {
+                    if (p > word_start) {
+                        words_.push_back({word_start, p - word_start, i});
+                    }
+                    word_start = p + 1;
+                }
+            }
+            for (uint32_t p = offset; p + 3 <= offset + length; ++p) {
+                trigrams.emplace_back(trigram_key(&text_[p]), i);
+            }
+        }
+    }
+    
+    std::sort(words_.begin(), words_.end(), [this](const Word& a, const Word& b) {
+        return word_text(a) < word_text(b) || (word_text(a) == word_text(b) && a.entry < b.entry);
+    });
+    
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    trigram_keys_.clear();
+    trigram_starts_.clear();
+    postings_.clear();
+    postings_.reserve(trigrams.size());
+    for (const auto& [key, entry] : trigrams) {
+        if (trigram_keys_.empty() || trigram_keys_.back() != key) {
+            trigram_keys_.push_back(key);
+            trigram_starts_.push_back(static_cast<uint32_t>(postings_.size()));
+        }
+        postings_.push_back(entry);
+    }
+    trigram_starts_.push_back(static_cast<uint32_t>(postings_.size()));
+    
+    // Memoria de trabajo para cualquier consulta
+    stamp_.assign(entries_.size(), 0);
+    hits_.assign(entries_.size(), 0);
+    candidates_.clear();
+    candidates_.reserve(entries_.size());
+    results_.clear();
+    results_.reserve(entries_.size());
+    generation_ = 0;
+    
+    default_order_.clear();
+    for (uint32_t i = 0; i < entries_.size(); ++i) {
+        default_order_.push_back({i, 0.0f});
+    }
+    default_order_dirty_ = true;
+}
+
+void AppSearch::set_frecency(uint32_t entry, double frecency) {
+    if (entry < frecency_bonus_.size()) {
+        frecency_bonus_[entry] = frecency_bonus(frecency);
+        default_order_dirty_ = true;
+    }
+}
+
+std::string_view AppSearch::name_of(uint32_t entry) const {
+    return std::string_view(text_).substr(entries_[entry].name_offset, entries_[entry].name_length);
+}
+
+std::string_view AppSearch::extra_of(uint32_t entry) const {
+    return std::string_view(text_).substr(entries_[entry].extra_offset, entries_[entry].extra_length);
+}
+
+std::string_view AppSearch::word_text(const Word& word) const {
+    return std::string_view(text_).substr(word.offset, word.length);
+}
+
+void AppSearch::add_candidate(uint32_t entry) {
+    if (stamp_[entry] != generation_) {
+        stamp_[entry] = generation_;
+        hits_[entry] = 0;
+        candidates_.push_back(entry);
+    }
+}
+
+float AppSearch::match_score(std::string_view query, uint32_t entry, uint32_t trigram_count) const {
+    // El resto de textos pesa 0.6: con el nombre como prefijo ya no pueden superarlo
+    float best = fuzzy_score(query, name_of(entry));
+    if (best < 150.0f) {
+        best = std::max(best, fuzzy_score(query, extra_of(entry)) * 0.6f);
+    }
+    if (best >= 0) {
+        return best;
+    }
+    
+    // Sin subsecuencia (p. ej. una errata): vale si comparte al menos la
+    // mitad de los trigramas de la consulta
+    uint32_t hits = hits_[entry] & TRIGRAM_HITS;
+    if (trigram_count > 0 && hits * 2 >= trigram_count) {
+        return 40.0f * hits / trigram_count;
+    }
+    return -1;
+}
+
+const std::vector<AppSearch::Result>& AppSearch::query(std::string_view text, size_t limit) {
+    auto start = std::chrono::steady_clock::now();
+    results_.clear();
+    candidates_.clear();
+    
+    size_t length = normalize(text, query_buffer_, MAX_QUERY);
+    std::string_view query(query_buffer_, length);
+    while (!query.empty() && query.front() == ' ') query.remove_prefix(1);
+    while (!query.empty() && query.back() == ' ') query.remove_suffix(1);
+    
+    auto better = [](const Result& a, const Result& b) {
+        return a.score > b.score || (a.score == b.score && a.entry < b.entry);
+    };
+    
+    if (query.empty()) {
+        // Orden por uso, calculado solo cuando cambia la frecuencia
+        if (default_order_dirty_) {
+            for (auto& result : default_order_) {
+                result.score = frecency_bonus_[result.entry];
+            }
+            std::sort(default_order_.begin(), default_order_.end(), better);
+            default_order_dirty_ = false;
+        }
+        results_.assign(default_order_.begin(),
+                        default_order_.begin() + std::min(limit, default_order_.size()));
+    } else {
+        // Nueva generación: las marcas anteriores dejan de contar sin borrarlas
+        if (++generation_ == 0) {
+            std::fill(stamp_.begin(), stamp_.end(), 0);
+            generation_ = 1;
+        }
+        
+        // Palabras que empiezan por la consulta (o por su primera palabra)
+        std::string_view prefix = query.substr(0, query.find(' '));
+        auto first = std::lower_bound(words_.begin(), words_.end(), prefix,
+            [this](const Word& word, std::string_view value) { return word_text(word) < value; });
+        for (auto it = first; it != words_.end() && word_text(*it).compare(0, prefix.size(), prefix) == 0; ++it) {
+            add_candidate(it->entry);
+            hits_[it->entry] |= PREFIX_HIT;
+        }
+        
+        // Entradas que comparten trigramas con la consulta
+        uint32_t trigram_count = 0;
+        for (size_t p = 0; p + 3 <= query.size(); ++p) {
+            trigram_count++;
+            uint32_t key = trigram_key(query.data() + p);
+            auto it = std::lower_bound(trigram_keys_.begin(), trigram_keys_.end(), key);
+            if (it == trigram_keys_.end() || *it != key) {
+                continue;
+            }
+            size_t slot = static_cast<size_t>(it - trigram_keys_.begin());
+            for (uint32_t i = trigram_starts_[slot]; i < trigram_starts_[slot + 1]; ++i) {
+                uint32_t entry = postings_[i];
+                add_candidate(entry);
+                hits_[entry]++;
+            }
+        }
+        
+        for (uint32_t entry : candidates_) {
+            // Sin prefijo, solo cuentan las que comparten la mitad de los trigramas
+            if (!(hits_[entry] & PREFIX_HIT) && (hits_[entry] & TRIGRAM_HITS) * 2u < trigram_count) {
+                continue;
+            }
+            float score = match_score(query, entry, trigram_count);
+            if (score >= 0) {
+                results_.push_back({entry, score + frecency_bonus_[entry]});
+            }
+        }
+    }
+    
+    // Mejor puntuación primero; a igualdad, orden alfabético del índice
+    if (limit < results_.size()) {
+        std::partial_sort(results_.begin(), results_.begin() + limit, results_.end(), better);
+        results_.resize(limit);
+    } else {
+        std::sort(results_.begin(), results_.end(), better);
+    }
+    
+    last_query_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return results_;
+}
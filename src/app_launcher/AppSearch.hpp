@@ -0,0 +1,86 @@
+// AppSearch.hpp
+#pragma once
+#include "AppIndex.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Frecency;
+
+// Búsqueda incremental sobre el índice de aplicaciones. Al construirse
+// prepara un índice de prefijos de palabras y otro de trigramas sobre el
+// nombre, las palabras clave, el nombre genérico y el ejecutable. Cada
+// consulta usa solo memoria reservada de antemano: escribir una tecla no
+// reserva nada.
+class AppSearch {
+public:
+    struct Result {
+        uint32_t entry;     // Posición en AppIndex::entries()
+        float score;
+    };
+
+    // Consultas más largas se recortan
+    static constexpr size_t MAX_QUERY = 64;
+
+    AppSearch() = default;
+
+    // Reconstruye todo para un índice nuevo
+    void rebuild(const AppIndex& index, const Frecency& frecency);
+    void set_frecency(uint32_t entry, double frecency);
+
+    // Resultados de mejor a peor, como mucho limit. Con texto vacío: todas
+    // las aplicaciones, las más usadas primero. La referencia es válida
+    // hasta la siguiente consulta.
+    const std::vector<Result>& query(std::string_view text, size_t limit);
+
+    size_t size() const { return entries_.size(); }
+    int64_t get_last_query_ns() const { return last_query_ns_; }
+
+private:
+    struct EntryText {
+        uint32_t name_offset;
+        uint32_t name_length;
+        uint32_t extra_offset;      // Palabras clave, nombre genérico y ejecutable
+        uint32_t extra_length;
+    };
+
+    struct Word {
+        uint32_t offset;
+        uint32_t length;
+        uint32_t entry;
+    };
+
+    std::string_view name_of(uint32_t entry) const;
+    std::string_view extra_of(uint32_t entry) const;
+    std::string_view word_text(const Word& word) const;
+    void add_candidate(uint32_t entry);
+    float match_score(std::string_view query, uint32_t entry, uint32_t trigram_count) const;
+
+    // Textos normalizados (minúsculas, sin tildes), todos seguidos
+    std::string text_;
+    std::vector<EntryText> entries_;
+    std::vector<float> frecency_bonus_;
+
+    // Índice de prefijos: palabras ordenadas alfabéticamente
+    std::vector<Word> words_;
+
+    // Índice de trigramas en formato compacto: claves ordenadas y, para
+    // cada clave, su tramo de postings_ (entradas ordenadas y sin repetir)
+    std::vector<uint32_t> trigram_keys_;
+    std::vector<uint32_t> trigram_starts_;
+    std::vector<uint32_t> postings_;
+
+    // Memoria de trabajo de query(), reservada en rebuild()
+    std::vector<uint32_t> stamp_;       // Generación en la que se vio cada entrada
+    std::vector<uint16_t> hits_;        // Trigramas de la consulta presentes
+    static constexpr uint16_t PREFIX_HIT = 0x8000;      // Alguna palabra empieza por la consulta
+    static constexpr uint16_t TRIGRAM_HITS = 0x7FFF;
+    std::vector<uint32_t> candidates_;
+    std::vector<Result> results_;
+    std::vector<Result> default_order_;     // Resultado de la consulta vacía
+    bool default_order_dirty_ = true;
+    uint32_t generation_ = 0;
+    char query_buffer_[MAX_QUERY];
+    int64_t last_query_ns_ = 0;
+};
@@ -0,0 +1,353 @@
+// AppSpawner.cpp
+#include "AppSpawner.hpp"
+#include <gdkmm.h>
+#include <giomm/desktopappinfo.h>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iostream>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace {
+
+// Sin posix_spawn_file_actions_addclosefrom_np (glibc < 2.34): marcar
+// FD_CLOEXEC en todo descriptor abierto por encima de stderr. No equivale a
+// addclosefrom: la marca queda puesta en el escritorio para siempre (nada
+// aquí pasa descriptores a un hijo por herencia, así que no importa) y no es
+// atómica. Un descriptor que otro hilo abra sin O_CLOEXEC entre este recorrido
+// y el exec del hijo se hereda; GLib y este código abren siempre con O_CLOEXEC,
+// así que solo afecta a bibliotecas que no lo hagan.
+void mark_descriptors_cloexec() {
+    DIR* dir = opendir("/proc/self/fd");
+    if (!dir) {
+        return;
+    }
+    int own = dirfd(dir);
+    while (dirent* item = readdir(dir)) {
+        int fd = std::atoi(item->d_name);
+        if (fd > 2 && fd != own) {
+            int flags = fcntl(fd, F_GETFD);
+            if (flags >= 0 && !(flags & FD_CLOEXEC)) {
+                fcntl(fd, F_SETFD, flags | FD_CLOEXEC);
+            }
+        }
+    }
+    closedir(dir);
+}
+
+} // namespace
+
+std::vector<std::string> AppSpawner::terminal_command() {
+    // $TERMINAL puede traer argumentos ("kitty --single-instance"): se separa
+    // con las reglas del shell para que cada palabra sea un argumento
+    const char* terminal = std::getenv("TERMINAL");
+    if (terminal && *terminal) {
+        gchar** words = nullptr;
+        GError* error = nullptr;
+        if (g_shell_parse_argv(terminal, nullptr, &words, &error)) {
+            std::vector<std::string> argv(words, words + g_strv_length(words));
+            g_strfreev(words);
+            return argv;
+        }
+        std::cerr << "$TERMINAL no válido (" << error->message << "), se busca otra terminal" << std::endl;
+        g_error_free(error);
+    }
+    for (const char* candidate : {"x-terminal-emulator", "gnome-terminal", "konsole", "xterm"}) {
+        std::string path = Glib::find_program_in_path(candidate);
+        if (!path.empty()) {
+            return {path};
+        }
+    }
+    return {"xterm"};
+}
+
+AppSpawner::AppSpawner() = default;
+
+AppSpawner::~AppSpawner() {
+    // Los hijos siguen vivos y GLib los recogerá al terminar (sin zombis);
+    // solo dejan de actualizar este registro
+    for (auto& [pid, watch] : child_watches_) {
+        watch->spawner = nullptr;
+    }
+}
+
+std::vector<std::string> AppSpawner::expand_exec(std::string_view exec, std::string_view name,
+                                                 std::string_view icon, std::string_view desktop_path,
+                                                 bool& ok) {
+    std::vector<std::string> argv;
+    std::string current;
+    bool in_argument = false;
+    bool quoted = false;
+    ok = true;
+    
+    auto finish_argument = [&]() {
+        if (in_argument) {
+            argv.push_back(std::move(current));
+            current.clear();
+            in_argument = false;
+        }
+    };
+    
+    for (size_t i = 0; i < exec.size(); ++i) {
+        char c = exec[i];
+        
+        if (quoted) {
+            if (c == '"') {
+                quoted = false;
+            } else if (c == '%' && i + 1 < exec.size() && exec[i + 1] == '%') {
+                current.push_back(exec[++i]);
+            } else if (c == '\\' && i + 1 < exec.size() && std::strchr("\"`$\\", exec[i + 1])) {
+                current.push_back(exec[++i]);
+            } else {
+                current.push_back(c);
+            }
+            continue;
+        }
+        
+        if (c == ' ' || c == '\t') {
+            finish_argument();
+            continue;
+        }
+        if (c == '"') {
+            quoted = true;
+            in_argument = true;
+            continue;
+        }
+        if (c == '%' && i + 1 < exec.size()) {
+            char code = exec[++i];
+            bool alone = !in_argument && (i + 1 == exec.size() || exec[i + 1] == ' ' || exec[i + 1] == '\t');
+            switch (code) {
+                case '%':
+                    current.push_back('%');
+                    in_argument = true;
+                    break;
+                case 'i':
+                    // --icon <icono>, solo si la entrada tiene icono
+                    if (!icon.empty() && alone) {
+                        argv.emplace_back("--icon");
+                        argv.emplace_back(icon);
+                    }
+                    break;
+                case 'c':
+                    current.append(name);
+                    in_argument = true;
+                    break;
+                case 'k':
+                    current.append(desktop_path);
+                    in_argument = true;
+                    break;
+                default:
+                    // %f %F %u %U sin archivos, y los obsoletos %d %D %n %N %v %m
+                    break;
+            }
+            continue;
+        }
+        current.push_back(c);
+        in_argument = true;
+    }
+    
+    if (quoted) {
+        ok = false;
+        return {};
+    }
+    finish_argument();
+    return argv;
+}
+
+pid_t AppSpawner::spawn(const std::vector<std::string>& argv, const std::string& token,
+                        const std::string& directory) {
+    std::vector<char*> args;
+    for (const auto& arg : argv) {
+        args.push_back(const_cast<char*>(arg.c_str()));
+    }
+    args.push_back(nullptr);
+    
+    // Entorno propio más el token de arranque
+    std::vector<std::string> extra_env;
+    std::vector<char*> env;
+    if (!token.empty()) {
+        extra_env.push_back("XDG_ACTIVATION_TOKEN=" + token);
+        extra_env.push_back("DESKTOP_STARTUP_ID=" + token);
+    }
+    for (char** var = environ; *var; ++var) {
+        if (!token.empty() && (std::strncmp(*var, "XDG_ACTIVATION_TOKEN=", 21) == 0 ||
+                               std::strncmp(*var, "DESKTOP_STARTUP_ID=", 19) == 0)) {
+            continue;
+        }
+        env.push_back(*var);
+    }
+    for (auto& var : extra_env) {
+        env.push_back(const_cast<char*>(var.c_str()));
+    }
+    env.push_back(nullptr);
+    
+    // Descriptores: stdin desde /dev/null y nada de lo nuestro por encima de stderr
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 34))
+    posix_spawn_file_actions_addclosefrom_np(&actions, 3);
+#else
+    mark_descriptors_cloexec();
+#endif
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+    if (!directory.empty()) {
+        posix_spawn_file_actions_addchdir_np(&actions, directory.c_str());
+    }
+#endif
+    
+    // Señales por defecto y sin máscara heredada; sesión propia para que la
+    // aplicación no muera con el escritorio
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    sigset_t empty_mask, all_signals;
+    sigemptyset(&empty_mask);
+    sigfillset(&all_signals);
+    sigdelset(&all_signals, SIGKILL);
+    sigdelset(&all_signals, SIGSTOP);
+    posix_spawnattr_setsigmask(&attributes, &empty_mask);
+    posix_spawnattr_setsigdefault(&attributes, &all_signals);
+    short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF;
+#ifdef POSIX_SPAWN_SETSID
+    flags |= POSIX_SPAWN_SETSID;
+#endif
+    posix_spawnattr_setflags(&attributes, flags);
+    
+    pid_t pid = 0;
+    int result = posix_spawnp(&pid, args[0], &actions, &attributes, args.data(), env.data());
+    
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&actions);
+    
+    if (result != 0) {
+        std::cerr << "No se pudo lanzar " << argv[0] << ": " << std::strerror(result) << std::endl;
+        return 0;
+    }
+    return pid;
+}
+
+bool AppSpawner::launch(const AppIndex& index, const AppIndex::Entry& entry, int64_t click_us) {
+    std::string name(index.str(entry.name));
+    std::string desktop_path(index.str(entry.path));
+    
+    bool ok = false;
+    auto argv = expand_exec(index.str(entry.exec), name, index.str(entry.icon), desktop_path, ok);
+    if (!ok || argv.empty()) {
+        std::cerr << "Exec no válido en " << desktop_path << std::endl;
+        return false;
+    }
+    if (entry.terminal) {
+        auto terminal = terminal_command();
+        terminal.push_back("-e");
+        argv.insert(argv.begin(), terminal.begin(), terminal.end());
+    }
+    
+    // Token de arranque (XDG_ACTIVATION_TOKEN / DESKTOP_STARTUP_ID): el
+    // compositor puede dar el foco a la ventana nueva y mostrar que se está abriendo
+    Glib::RefPtr<Gdk::AppLaunchContext> context;
+    Glib::RefPtr<Gio::DesktopAppInfo> info;
+    std::string token;
+    if (auto display = Gdk::Display::get_default()) {
+        context = display->get_app_launch_context();
+        info = Gio::DesktopAppInfo::create_from_filename(desktop_path);
+        if (info) {
+            token = context->get_startup_notify_id(info, {});
+        }
+    }
+    
+    pid_t pid = spawn(argv, token);
+    if (pid <= 0) {
+        // Sin esto el cursor de "abriendo" sigue hasta que caduca
+        if (!token.empty()) {
+            context->launch_failed(token);
+        }
+        return false;
+    }
+    if (!token.empty()) {
+        // Lo mismo que emite GDesktopAppInfo al lanzar por su cuenta
+        GVariantBuilder builder;
+        g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+        g_variant_builder_add(&builder, "{sv}", "pid", g_variant_new_int32(pid));
+        g_variant_builder_add(&builder, "{sv}", "startup-notification-id", g_variant_new_string(token.c_str()));
+        GVariant* platform_data = g_variant_ref_sink(g_variant_builder_end(&builder));
+        g_signal_emit_by_name(context->gobj(), "launched", info->gobj(), platform_data);
+        g_variant_unref(platform_data);
+    }
+    
+    LaunchRecord record;
+    record.desktop_id = std::string(index.str(entry.desktop_id));
+    record.name = name;
+    record.pid = pid;
+    record.click_us = click_us;
+    record.spawn_us = g_get_monotonic_time() - click_us;
+    std::cout << "Lanzado " << name << " (pid " << pid << "): clic a proceso en "
+              << record.spawn_us / 1000.0 << " ms" << std::endl;
+    
+    recent_.push_back(std::move(record));
+    if (recent_.size() > MAX_RECORDS) {
+        recent_.pop_front();
+    }
+    
+    watch_child(pid);
+    return true;
+}
+
+bool AppSpawner::spawn_command(const std::vector<std::string>& argv, const std::string& directory) {
+    if (argv.empty()) {
+        return false;
+    }
+    pid_t pid = spawn(argv, {}, directory);
+    if (pid <= 0) {
+        return false;
+    }
+    watch_child(pid);
+    return true;
+}
+
+void AppSpawner::watch_child(pid_t pid) {
+    // GLib recoge al hijo (waitpid) y avisa en el bucle principal
+    auto* watch = new ChildWatch{this, pid};
+    child_watches_[pid] = watch;
+    g_child_watch_add(pid, &AppSpawner::on_child_exited, watch);
+}
+
+void AppSpawner::mark_first_window() {
+    if (recent_.empty() || recent_.back().first_window_us >= 0) {
+        return;
+    }
+    auto& record = recent_.back();
+    record.first_window_us = g_get_monotonic_time() - record.click_us;
+    std::cout << "Primera ventana de " << record.name << " en "
+              << record.first_window_us / 1000.0 << " ms" << std::endl;
+}
+
+void AppSpawner::on_child_exited(GPid pid, gint status, gpointer data) {
+    // La vigilancia de un hijo se dispara una sola vez
+    auto* watch = static_cast<ChildWatch*>(data);
+    g_spawn_close_pid(pid);
+    if (watch->spawner) {
+        watch->spawner->record_exit(pid, status);
+    }
+    delete watch;
+}
+
+void AppSpawner::record_exit(pid_t pid, int status) {
+    child_watches_.erase(pid);
+    for (auto& record : recent_) {
+        if (record.pid == pid && !record.exited) {
+            record.exited = true;
+            record.exit_status = status;
+            // Salir enseguida con error suele indicar un Exec roto
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                std::cerr << record.name << " terminó con error (estado " << status << ")" << std::endl;
+            }
+        }
+    }
+}
@@ -0,0 +1,79 @@
+// AppSpawner.hpp
+#pragma once
+#include <glibmm.h>
+#include <sys/types.h>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "AppIndex.hpp"
+
+// Lanza aplicaciones del índice sin bloquear el bucle principal: interpreta
+// Exec= (comillas y códigos %f, %u, %i, %c, %k...), arranca el proceso con
+// posix_spawn y GLib lo recoge al terminar (g_child_watch), aunque el
+// AppSpawner ya no exista. Guarda los tiempos de cada lanzamiento para
+// detectar aplicaciones lentas.
+class AppSpawner {
+public:
+    struct LaunchRecord {
+        std::string desktop_id;
+        std::string name;
+        pid_t pid = 0;
+        int64_t click_us = 0;           // Momento del clic (g_get_monotonic_time)
+        int64_t spawn_us = 0;           // Clic -> proceso creado
+        int64_t first_window_us = -1;   // Clic -> primera ventana; -1 si no se detectó
+        bool exited = false;
+        int exit_status = 0;
+    };
+
+    AppSpawner();
+    ~AppSpawner();
+
+    // false si Exec no se puede interpretar o el proceso no arranca
+    bool launch(const AppIndex& index, const AppIndex::Entry& entry, int64_t click_us);
+
+    // Orden suelta (p. ej. la terminal del menú) con la misma higiene de
+    // descriptores y recogida que launch(). directory vacío: el actual
+    bool spawn_command(const std::vector<std::string>& argv, const std::string& directory = {});
+
+    // $TERMINAL (ya separado en argumentos) o el primer emulador de
+    // terminal instalado
+    static std::vector<std::string> terminal_command();
+
+    // La última aplicación lanzada mostró su primera ventana
+    void mark_first_window();
+
+    // Exec= convertido en argumentos según la especificación de .desktop.
+    // Sin archivos que abrir, %f %F %u %U desaparecen. ok = false si las
+    // comillas no cierran.
+    static std::vector<std::string> expand_exec(std::string_view exec, std::string_view name,
+                                                std::string_view icon, std::string_view desktop_path,
+                                                bool& ok);
+
+    // Últimos lanzamientos, el más reciente al final
+    const std::deque<LaunchRecord>& get_recent() const { return recent_; }
+
+    AppSpawner(const AppSpawner&) = delete;
+    AppSpawner& operator=(const AppSpawner&) = delete;
+
+private:
+    static constexpr size_t MAX_RECORDS = 32;
+
+    // Vigilancia de un hijo; vive hasta que el hijo termina. spawner pasa a
+    // nulo si el AppSpawner se destruye antes
+    struct ChildWatch {
+        AppSpawner* spawner;
+        pid_t pid;
+    };
+
+    pid_t spawn(const std::vector<std::string>& argv, const std::string& activation_token,
+                const std::string& directory = {});
+    void watch_child(pid_t pid);
+    void record_exit(pid_t pid, int status);
+    static void on_child_exited(GPid pid, gint status, gpointer data);
+
+    std::deque<LaunchRecord> recent_;
+    std::map<pid_t, ChildWatch*> child_watches_;    // Procesos vivos
+};
@@ -0,0 +1,113 @@
+// Frecency.cpp
+#include "Frecency.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Peso de un uso según su antigüedad, por tramos de días
+double recency_weight(int64_t last_used, int64_t now) {
+    int64_t days = (now - last_used) / 86400;
+    if (days <= 4) return 100;
+    if (days <= 14) return 70;
+    if (days <= 31) return 50;
+    if (days <= 90) return 30;
+    return 10;
+}
+
+} // namespace
+
+Frecency::Frecency(std::string file_path)
+    : file_path_(std::move(file_path)) {
+    load();
+}
+
+void Frecency::load() {
+    std::ifstream file(file_path_);
+    if (!file) {
+        return;
+    }
+    
+    nlohmann::json data = nlohmann::json::parse(file, nullptr, false);
+    if (!data.is_object()) {
+        std::cerr << "Historial de uso inválido: " << file_path_ << std::endl;
+        return;
+    }
+    
+    for (auto it = data.begin(); it != data.end(); ++it) {
+        const auto& value = it.value();
+        if (!value.is_object()) {
+            continue;
+        }
+        // Un archivo editado a mano no debe impedir el arranque: las entradas
+        // con campos de otro tipo se ignoran
+        auto count = value.find("count");
+        auto last_used = value.find("last_used");
+        if (count == value.end() || !count->is_number_unsigned() ||
+            last_used == value.end() || !last_used->is_number_integer()) {
+            std::cerr << "Entrada de historial inválida, se ignora: " << it.key() << std::endl;
+            continue;
+        }
+        Usage usage;
+        usage.count = static_cast<uint32_t>(std::min<uint64_t>(count->get<uint64_t>(), UINT32_MAX));
+        usage.last_used = last_used->get<int64_t>();
+        if (usage.count > 0) {
+            usage_[it.key()] = usage;
+        }
+    }
+}
+
+void Frecency::record(const std::string& desktop_id) {
+    Usage& usage = usage_[desktop_id];
+    usage.count++;
+    usage.last_used = static_cast<int64_t>(std::time(nullptr));
+    
+    if (!save()) {
+        std::cerr << "No se pudo guardar el historial de uso en " << file_path_ << std::endl;
+    }
+}
+
+double Frecency::score(const std::string& desktop_id) const {
+    auto it = usage_.find(desktop_id);
+    if (it == usage_.end()) {
+        return 0;
+    }
+    return it->second.count * recency_weight(it->second.last_used, static_cast<int64_t>(std::time(nullptr)));
+}
+
+bool Frecency::save() const {
+    nlohmann::json data = nlohmann::json::object();
+    for (const auto& [desktop_id, usage] : usage_) {
+        data[desktop_id] = {{"count", usage.count}, {"last_used", usage.last_used}};
+    }
+    
+    std::error_code ec;
+    fs::create_directories(fs::path(file_path_).parent_path(), ec);
+    
+    // Escritura atómica: archivo temporal y rename
+    std::string temp_path = file_path_ + ".tmp." + std::to_string(::getpid());
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << data.dump(2);
+        if (!file.good()) {
+            return false;
+        }
+    }
+    if (std::rename(temp_path.c_str(), file_path_.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
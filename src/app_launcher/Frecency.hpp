@@ -0,0 +1,30 @@
+// Frecency.hpp
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Uso de cada aplicación (veces y último lanzamiento), guardado en disco.
+// La puntuación combina ambos: cuenta cada uso, pesando más los recientes.
+class Frecency {
+public:
+    explicit Frecency(std::string file_path);
+
+    // Anota un lanzamiento y guarda el archivo
+    void record(const std::string& desktop_id);
+    double score(const std::string& desktop_id) const;
+
+    bool save() const;
+
+private:
+    struct Usage {
+        uint32_t count = 0;
+        int64_t last_used = 0;      // Segundos desde epoch
+    };
+
+    void load();
+
+    std::string file_path_;
+    std::unordered_map<std::string, Usage> usage_;
+};
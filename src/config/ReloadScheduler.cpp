@@ -0,0 +1,66 @@
+// ReloadScheduler.cpp
+#include "ReloadScheduler.hpp"
+#include <iostream>
+
+ReloadScheduler::ReloadScheduler(FlushCallback flush, unsigned int window_ms)
+    : flush_(std::move(flush)), window_ms_(window_ms) {}
+
+ReloadScheduler::~ReloadScheduler() {
+    timer_.disconnect();
+}
+
+void ReloadScheduler::request_full() {
+    pending_full_ = true;
+    arm();
+}
+
+void ReloadScheduler::request_component(const std::string& component_name) {
+    pending_components_.insert(component_name);
+    arm();
+}
+
+void ReloadScheduler::arm() {
+    stats_.events++;
+    
+    // Ya hay una recarga en camino: este evento se suma a ella
+    if (timer_.connected()) {
+        stats_.coalesced++;
+        return;
+    }
+    
+    // Prioridad idle: la recarga corre después de los eventos y el redibujado pendientes
+    timer_ = Glib::signal_timeout().connect(
+        sigc::mem_fun(*this, &ReloadScheduler::on_window_elapsed),
+        window_ms_, Glib::PRIORITY_DEFAULT_IDLE
+    );
+}
+
+bool ReloadScheduler::on_window_elapsed() {
+    // Los eventos que lleguen durante la recarga abren una ventana nueva
+    timer_.disconnect();
+    
+    bool full = pending_full_;
+    std::vector<std::string> components;
+    if (!full) {
+        components.assign(pending_components_.begin(), pending_components_.end());
+    }
+    pending_full_ = false;
+    pending_components_.clear();
+    
+    stats_.reloads++;
+    if (full) {
+        stats_.full_reloads++;
+    }
+    std::cout << "Recargando tema (" << stats_.events << " eventos, "
+              << stats_.coalesced << " agrupados, "
+              << stats_.reloads << " recargas)" << std::endl;
+    
+    if (flush_) {
+        flush_(full, components);
+    }
+    return false; // Una sola vez por ventana
+}
+
+const ReloadScheduler::Stats& ReloadScheduler::get_stats() const {
+    return stats_;
+}
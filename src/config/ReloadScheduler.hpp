@@ -0,0 +1,47 @@
+// ReloadScheduler.hpp
+#pragma once
+#include <glibmm.h>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+// Agrupa los eventos de archivo que llegan en una ventana corta y los
+// convierte en una sola recarga. Un guardado de editor suele generar varios
+// eventos (CHANGED, CHANGES_DONE_HINT, CREATED...) en pocos milisegundos.
+class ReloadScheduler {
+public:
+    // full == true: recargar todo el tema; si no, solo los componentes dados
+    using FlushCallback = std::function<void(bool full, const std::vector<std::string>& components)>;
+
+    struct Stats {
+        uint64_t events = 0;        // Eventos recibidos
+        uint64_t coalesced = 0;     // Eventos absorbidos por una recarga ya pendiente
+        uint64_t reloads = 0;       // Recargas realmente ejecutadas
+        uint64_t full_reloads = 0;
+    };
+
+    ReloadScheduler(FlushCallback flush, unsigned int window_ms = 100);
+    ~ReloadScheduler();
+
+    void request_full();
+    void request_component(const std::string& component_name);
+
+    const Stats& get_stats() const;
+
+    ReloadScheduler(const ReloadScheduler&) = delete;
+    ReloadScheduler& operator=(const ReloadScheduler&) = delete;
+
+private:
+    void arm();
+    bool on_window_elapsed();
+
+    FlushCallback flush_;
+    unsigned int window_ms_;
+    sigc::connection timer_;
+
+    bool pending_full_ = false;
+    std::set<std::string> pending_components_;
+    Stats stats_;
+};
@@ -5,8 +5,8 @@
 
 namespace fs = std::filesystem;
 
-ThemeLoader::ThemeLoader(const std::string& theme_dir)
-    : theme_dir_(theme_dir) {
+ThemeLoader::ThemeLoader(const std::string& theme_dir, ReloadCallback on_reload)
+    : theme_dir_(theme_dir), scheduler_(std::move(on_reload)) {
     if (!fs::exists(theme_dir_)) {
         fs::create_directories(theme_dir_);
     }
@@ -29,16 +29,18 @@ void ThemeLoader::watch_for_changes() {
     setup_file_monitor(theme_dir_, "all");
 }
 
-void ThemeLoader::register_component(const std::string& component_name, ThemeChangeCallback callback) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    callbacks_[component_name] = callback;
+void ThemeLoader::register_component(const std::string& component_name, const std::string& css_path) {
+    component_files_[fs::absolute(css_path).lexically_normal().string()] = component_name;
     
-    std::string css_path = theme_dir_ + "/" + component_name + ".css";
     if (fs::exists(css_path)) {
         setup_file_monitor(css_path, component_name);
     }
 }
 
+const ReloadScheduler::Stats& ThemeLoader::get_stats() const {
+    return scheduler_.get_stats();
+}
+
 void ThemeLoader::setup_file_monitor(const std::string& file_path, const std::string& component_name) {
     if (monitors_.find(file_path) != monitors_.end()) {
         return;
@@ -89,34 +91,35 @@ void ThemeLoader::on_file_changed(const Glib::RefPtr<Gio::File>& file,
                                   Gio::FileMonitor::Event event_type,
                                   const std::string& component_name) {
     
-    // Solo procesar eventos de cambio reales
+    // Solo procesar eventos de cambio reales. Un guardado atómico llega como
+    // CREATED; los duplicados los agrupa el scheduler en una sola recarga
     if (event_type != Gio::FileMonitor::Event::CHANGED &&
-        event_type != Gio::FileMonitor::Event::CHANGES_DONE_HINT) {
+        event_type != Gio::FileMonitor::Event::CHANGES_DONE_HINT &&
+        event_type != Gio::FileMonitor::Event::CREATED) {
         return;
     }
     
-    std::lock_guard<std::mutex> lock(mutex_);
     std::cout << "Cambio detectado en: " << file->get_path() << std::endl;
     
-    if (component_name == "global" || component_name == "all") {
-        for (auto& [comp_name, callback] : callbacks_) {
-            try {
-                callback(comp_name);
-            }
-            catch (const std::exception& e) {
-                std::cerr << "Error en callback para " << comp_name << ": " << e.what() << std::endl;
-            }
-        }
+    if (component_name == "global") {
+        scheduler_.request_full();
+        return;
     }
-    else {
-        auto it = callbacks_.find(component_name);
-        if (it != callbacks_.end()) {
-            try {
-                it->second(component_name);
-            }
-            catch (const std::exception& e) {
-                std::cerr << "Error en callback para " << component_name << ": " << e.what() << std::endl;
-            }
+    
+    if (component_name == "all") {
+        // Monitor del directorio: averiguar qué archivo cambió
+        auto path = fs::path(file->get_path()).lexically_normal();
+        if (path.filename() == "theme.json") {
+            scheduler_.request_full();
+            return;
+        }
+        
+        auto it = component_files_.find(path.string());
+        if (it != component_files_.end()) {
+            scheduler_.request_component(it->second);
         }
+        return;
     }
-}
\ No newline at end of file
+    
+    scheduler_.request_component(component_name);
+}
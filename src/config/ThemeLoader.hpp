@@ -4,30 +4,32 @@
 #include <unordered_map>
 #include <glibmm.h>
 #include <giomm.h>  // AÑADIDO: Necesario para Gio::FileMonitor
-#include <mutex>
+#include "ReloadScheduler.hpp"
 
 class ThemeLoader {
 public:
-    using ThemeChangeCallback = std::function<void(const std::string& component_name)>;
+    using ReloadCallback = ReloadScheduler::FlushCallback;
     
-    ThemeLoader(const std::string& theme_dir);
+    ThemeLoader(const std::string& theme_dir, ReloadCallback on_reload);
     ~ThemeLoader();
     
     void watch_for_changes();
-    void register_component(const std::string& component_name, ThemeChangeCallback callback);
+    void register_component(const std::string& component_name, const std::string& css_path);
+
+    const ReloadScheduler::Stats& get_stats() const;
     
     ThemeLoader(const ThemeLoader&) = delete;
     ThemeLoader& operator=(const ThemeLoader&) = delete;
 
 private:
     std::string theme_dir_;
-    std::unordered_map<std::string, ThemeChangeCallback> callbacks_;
+    std::unordered_map<std::string, std::string> component_files_; // ruta CSS -> componente
     std::unordered_map<std::string, Glib::RefPtr<Gio::FileMonitor>> monitors_;
-    std::mutex mutex_;
+    ReloadScheduler scheduler_;
     
     void setup_file_monitor(const std::string& file_path, const std::string& component_name);
     void on_file_changed(const Glib::RefPtr<Gio::File>& file,
                          const Glib::RefPtr<Gio::File>& other_file,
                          Gio::FileMonitor::Event event_type,
                          const std::string& component_name);
-};
\ No newline at end of file
+};
@@ -1,143 +1,192 @@
 // ThemeManager.cpp
 #include "ThemeManager.hpp"
 #include "ThemeLoader.hpp"
-#include <fstream>
-#include <sstream>
+#include "../core/Tracer.hpp"
+#include <chrono>
 #include <iostream>
 
-namespace fs = std::filesystem;
-
 ThemeManager::ThemeManager(const std::string& theme_dir)
     : theme_dir_(theme_dir), css_parser_(std::make_unique<CSSParser>()) {
     
-    // Crear ThemeLoader
-    theme_loader_ = std::make_unique<ThemeLoader>(theme_dir_);
+    // Un único proveedor para todo el display; las recargas lo actualizan en sitio
+    display_provider_ = Gtk::CssProvider::create();
+    auto display = Gdk::Display::get_default();
+    if (display) {
+        Gtk::StyleProvider::add_provider_for_display(display, display_provider_,
+                                                     GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+    }
     
-    // Registrar recarga global
-    theme_loader_->register_component("global", [this](const std::string&) {
-        this->reload();
-    });
+    build_done_.open("theme_build_done", [this](const BuildResult& result) { on_build_done(result); });
+
+    // Crear ThemeLoader; los eventos de archivo llegan ya agrupados
+    theme_loader_ = std::make_unique<ThemeLoader>(theme_dir_,
+        [this](bool full, const std::vector<std::string>& components) {
+            if (full) {
+                this->reload();
+                return;
+            }
+            for (const auto& component_name : components) {
+                this->reload_component(component_name);
+            }
+        });
     
     // Iniciar monitoreo
     theme_loader_->watch_for_changes();
 
-    // Cargar tema inicial
-    reload();
+    // El tema inicial se carga de forma síncrona: todavía no hay ventanas
+    // que bloquear y los componentes lo necesitan nada más construirse
+    auto initial = ThemeSnapshot::load(theme_dir_, template_cache_, *css_parser_);
+    if (initial) {
+        apply_snapshot(initial);
+    } else {
+        std::atomic_store(&snapshot_, std::make_shared<const ThemeSnapshot>());
+    }
+}
+
+ThemeManager::~ThemeManager() {
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    // Un resultado aún en cola ya no encuentra suscriptor
+    build_done_.close();
+    
+    auto display = Gdk::Display::get_default();
+    if (display && display_provider_) {
+        Gtk::StyleProvider::remove_provider_for_display(display, display_provider_);
+    }
 }
 
 void ThemeManager::reload() {
-    load_global_theme();
-    load_component_styles();
+    TraceSpan span("ThemeManager::reload");
+    pending_full_ = true;
+    start_build();
 }
 
 void ThemeManager::reload_component(const std::string& component_name) {
-    std::string config_path = theme_dir_ + "/theme.json";
-    std::ifstream file(config_path);
-    
-    if (!file) {
-        std::cerr << "No se pudo abrir " << config_path << std::endl;
+    pending_components_.insert(component_name);
+    start_build();
+}
+
+void ThemeManager::start_build() {
+    // Solo un hilo de construcción a la vez; lo pendiente se lanza al terminar
+    if (building_ || (!pending_full_ && pending_components_.empty())) {
         return;
     }
     
-    try {
-        nlohmann::json theme_config;
-        file >> theme_config;
-        
-        if (theme_config["components"].contains(component_name)) {
-            std::string css_path = theme_dir_ + "/" + 
-                                   theme_config["components"][component_name].get<std::string>();
-            process_component_css(component_name, css_path);
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "Error recargando componente: " << e.what() << std::endl;
+    bool full = pending_full_;
+    std::vector<std::string> components(pending_components_.begin(), pending_components_.end());
+    pending_full_ = false;
+    pending_components_.clear();
+    
+    auto base = get_snapshot();
+    if (worker_.joinable()) {
+        worker_.join();
     }
+    building_ = true;
+    build_started_us_ = g_get_monotonic_time();
+    
+    worker_ = std::thread([this, full, components, base]() {
+        TraceSpan span("ThemeManager::build");
+        std::shared_ptr<const ThemeSnapshot> result;
+        if (full) {
+            result = ThemeSnapshot::load(theme_dir_, template_cache_, *css_parser_, base.get());
+        } else {
+            result = ThemeSnapshot::with_components(*base, components, template_cache_, *css_parser_);
+        }
+        build_done_.post(BuildResult{std::move(result)});
+    });
 }
 
-void ThemeManager::load_global_theme() {
-    std::string config_path = theme_dir_ + "/theme.json";
-    std::ifstream file(config_path);
-    
-    if (!file) {
-        std::cerr << "No se pudo abrir " << config_path << std::endl;
-        return;
+void ThemeManager::on_build_done(const BuildResult& result) {
+    if (worker_.joinable()) {
+        worker_.join();
     }
+    building_ = false;
     
-    try {
-        nlohmann::json theme_config;
-        file >> theme_config;
-        global_vars_ = theme_config["global"];
-    } catch (const std::exception& e) {
-        std::cerr << "Error leyendo el JSON global: " << e.what() << std::endl;
+    // Un tema inválido se descarta y se conserva el anterior
+    if (result.snapshot) {
+        apply_snapshot(result.snapshot);
+        style_stats_.reload_us.record(g_get_monotonic_time() - build_started_us_);
+    } else {
+        std::cerr << "Tema inválido, se mantiene el anterior" << std::endl;
     }
+    
+    start_build();
 }
 
-void ThemeManager::load_component_styles() {
-    std::string config_path = theme_dir_ + "/theme.json";
-    std::ifstream file(config_path);
-    
-    if (!file) {
-        std::cerr << "No se pudo abrir " << config_path << std::endl;
-        return;
-    }
+void ThemeManager::apply_snapshot(std::shared_ptr<const ThemeSnapshot> snapshot) {
+    TraceSpan span("ThemeManager::apply_snapshot");
+    std::vector<std::string> changed = snapshot->changed_components;
     
-    try {
-        nlohmann::json theme_config;
-        file >> theme_config;
+    if (!changed.empty()) {
+        // Hoja combinada: cada componente ya viene limitado a su clase CSS,
+        // así un solo proveedor sirve a todas las ventanas
+        size_t total_size = 0;
+        for (const auto& component : snapshot->components) {
+            total_size += component.css.size() + 1;
+        }
+        std::string merged_css;
+        merged_css.reserve(total_size);
+        for (const auto& component : snapshot->components) {
+            merged_css.append(component.css);
+            merged_css.push_back('\n');
+        }
         
-        if (!theme_config.contains("components")) {
-            std::cerr << "No se encontró la sección 'components' en theme.json" << std::endl;
-            return;
+        auto start = std::chrono::steady_clock::now();
+        style_stats_.applied_at_us = g_get_monotonic_time();
+        try {
+            display_provider_->load_from_data(merged_css);
+        } catch (const Glib::Error& e) {
+            std::cerr << "Error aplicando CSS del tema: " << e.what() << std::endl;
         }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
         
-        auto components = theme_config["components"];
-        for (auto& [component_name, css_file] : components.items()) {
-            std::string css_path = theme_dir_ + "/" + css_file.get<std::string>();
-            process_component_css(component_name, css_path);
-            
-            // Registrar componente en ThemeLoader para monitoreo
-            if (theme_loader_) {
-                theme_loader_->register_component(component_name, [this, component_name](const std::string&) {
-                    this->reload_component(component_name);
-                });
-            }
+        style_stats_.loads++;
+        style_stats_.css_bytes = merged_css.size();
+        style_stats_.css_bytes_total += merged_css.size();
+        style_stats_.last_load_us = elapsed.count();
+        std::cout << "Tema aplicado: " << changed.size() << " componentes cambiados, "
+                  << merged_css.size() << " bytes, " << style_stats_.providers
+                  << " proveedor, " << elapsed.count() << " us" << std::endl;
+    }
+    
+    // Registrar componentes nuevos en ThemeLoader para monitoreo
+    for (const auto& component : snapshot->components) {
+        if (theme_loader_ && registered_components_.insert(component.name).second) {
+            theme_loader_->register_component(component.name, component.css_path);
         }
-    } catch (const std::exception& e) {
-        std::cerr << "Error cargando componentes: " << e.what() << std::endl;
+    }
+    
+    std::atomic_store(&snapshot_, std::move(snapshot));
+    if (!changed.empty()) {
+        signal_reloaded_.emit(changed);
     }
 }
 
+nlohmann::json ThemeManager::get_global_vars() const {
+    // Copia: el snapshot puede sustituirse en cuanto se suelta
+    return get_snapshot()->global_vars;
+}
 
-void ThemeManager::process_component_css(const std::string& component_name, const std::string& css_path) {
-    if (!fs::exists(css_path)) {
-        std::cerr << "Archivo CSS no encontrado: " << css_path << std::endl;
-        return;
-    }
-    
-    std::ifstream css_file(css_path);
-    std::stringstream buffer;
-    buffer << css_file.rdbuf();
-    std::string css_content = buffer.str();
-    
-    // Procesar variables CSS
-    std::string processed_css = css_parser_->parse(css_content, global_vars_);
-    
-    auto provider = Gtk::CssProvider::create();
-    try {
-        provider->load_from_data(processed_css);
-        component_providers_[component_name] = provider;
-    } catch (const Glib::Error& e) {
-        std::cerr << "Error aplicando CSS para " << component_name << ": " << e.what() << std::endl;
-    }
+std::shared_ptr<const ThemeSnapshot> ThemeManager::get_snapshot() const {
+    return std::atomic_load(&snapshot_);
 }
 
-Glib::RefPtr<Gtk::CssProvider> ThemeManager::get_component_provider(const std::string& component_name) const {
-    auto it = component_providers_.find(component_name);
-    if (it != component_providers_.end()) {
-        return it->second;
-    }
-    return nullptr;
+const ThemeManager::StyleStats& ThemeManager::get_style_stats() const {
+    return style_stats_;
+}
+
+void ThemeManager::record_restyle(int64_t painted_us) {
+    int64_t elapsed = painted_us - style_stats_.applied_at_us;
+    style_stats_.restyle_us.record(elapsed);
+    std::cout << "Tema repintado: " << elapsed << " us (estilo, layout y pintado)" << std::endl;
+}
+
+const ReloadScheduler::Stats& ThemeManager::get_reload_stats() const {
+    return theme_loader_->get_stats();
 }
 
-const nlohmann::json& ThemeManager::get_global_vars() const {
-    return global_vars_;
+sigc::signal<void(const std::vector<std::string>&)>& ThemeManager::signal_reloaded() {
+    return signal_reloaded_;
 }
@@ -4,29 +4,83 @@
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
+#include <thread>
 #include "ThemeLoader.hpp"             // Para carga dinámica de temas
+#include "ThemeSnapshot.hpp"           // Estado inmutable del tema
 #include "../utils/CSSParser.hpp"      // Procesamiento de variables CSS
+#include "../utils/CSSTemplateCache.hpp" // Plantillas CSS compiladas
+#include "../utils/Histogram.hpp"
+#include "../core/EventManager.hpp"  // Entrega del resultado al hilo principal
 
 class ThemeManager {
 public:
     ThemeManager(const std::string& theme_dir);
+    ~ThemeManager();
     
+    // Ambas recargas son asíncronas: el tema se construye en un hilo de
+    // trabajo y se publica en el hilo principal al terminar.
     void reload();
     void reload_component(const std::string& component_name);
     
-    Glib::RefPtr<Gtk::CssProvider> get_component_provider(const std::string& component_name) const;
-    const nlohmann::json& get_global_vars() const;
+    // Métricas del proveedor CSS compartido
+    struct StyleStats {
+        unsigned int providers = 1;     // Siempre uno por display
+        uint64_t loads = 0;             // Veces que se recargó en sitio
+        size_t css_bytes = 0;           // Tamaño de la hoja combinada
+        uint64_t css_bytes_total = 0;   // Bytes de CSS cargados en total
+        int64_t last_load_us = 0;       // Duración de la última recarga
+        Histogram reload_us;            // Recargas completas: construcción + aplicación
+        int64_t applied_at_us = 0;      // Momento de la última carga en el proveedor
+        Histogram restyle_us;           // Carga -> primer frame pintado con el tema nuevo
+    };
+
+    nlohmann::json get_global_vars() const;
+    std::shared_ptr<const ThemeSnapshot> get_snapshot() const;
+    const ReloadScheduler::Stats& get_reload_stats() const;
+    const StyleStats& get_style_stats() const;
+
+    // Lo llama quien observa el primer frame pintado tras signal_reloaded()
+    void record_restyle(int64_t painted_us);
+
+    // Se emite en el hilo principal con los componentes cuyo CSS cambió
+    sigc::signal<void(const std::vector<std::string>&)>& signal_reloaded();
+
+    ThemeManager(const ThemeManager&) = delete;
+    ThemeManager& operator=(const ThemeManager&) = delete;
 
 private:
-    void load_global_theme();
-    void load_component_styles();
-    void process_component_css(const std::string& component_name, const std::string& css_path);
+    // Resultado del hilo de construcción; llega por build_done_
+    struct BuildResult {
+        std::shared_ptr<const ThemeSnapshot> snapshot;  // Nulo si el tema es inválido
+    };
+
+    void start_build();
+    void on_build_done(const BuildResult& result);
+    void apply_snapshot(std::shared_ptr<const ThemeSnapshot> snapshot);
     
     std::string theme_dir_;
-    nlohmann::json global_vars_;
-    std::unordered_map<std::string, Glib::RefPtr<Gtk::CssProvider>> component_providers_;
+    Glib::RefPtr<Gtk::CssProvider> display_provider_;
+    StyleStats style_stats_;
+    std::unordered_set<std::string> registered_components_;
+
+    // Solo los usa el hilo de construcción (o el constructor, antes de lanzarlo)
     std::unique_ptr<CSSParser> css_parser_;
+    CSSTemplateCache template_cache_;
+
+    // Tema publicado; se sustituye con std::atomic_store
+    std::shared_ptr<const ThemeSnapshot> snapshot_;
+
+    // Construcción en segundo plano
+    std::thread worker_;
+    WorkerResults<BuildResult> build_done_;
+    bool building_ = false;
+    int64_t build_started_us_ = 0;
+    bool pending_full_ = false;
+    std::unordered_set<std::string> pending_components_;
+
+    sigc::signal<void(const std::vector<std::string>&)> signal_reloaded_;
 
     std::unique_ptr<ThemeLoader> theme_loader_; 
 };
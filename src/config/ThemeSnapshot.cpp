@@ -0,0 +1,187 @@
+// ThemeSnapshot.cpp
+#include "ThemeSnapshot.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <unordered_set>
+
+namespace {
+
+bool contains(const std::vector<std::string>& names, const std::string& name) {
+    return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+// Variables cuyo valor es distinto (o que aparecen/desaparecen) entre dos temas
+std::unordered_set<std::string> diff_variables(const nlohmann::json& before, const nlohmann::json& after) {
+    std::unordered_set<std::string> changed;
+    for (auto& [name, value] : after.items()) {
+        auto it = before.find(name);
+        if (it == before.end() || *it != value) {
+            changed.insert(name);
+        }
+    }
+    for (auto& [name, value] : before.items()) {
+        if (!after.contains(name)) {
+            changed.insert(name);
+        }
+    }
+    return changed;
+}
+
+} // namespace
+
+const ThemeSnapshot::Component* ThemeSnapshot::find_component(const std::string& name) const {
+    for (const auto& component : components) {
+        if (component.name == name) {
+            return &component;
+        }
+    }
+    return nullptr;
+}
+
+void ThemeSnapshot::index_component(Component& component) {
+    // Cierre transitivo: si --a vale "var(--b)", cambiar --b también afecta
+    component.variables = component.tmpl->variables;
+    for (size_t i = 0; i < component.variables.size(); ++i) {
+        auto it = global_vars.find(component.variables[i]);
+        if (it != global_vars.end() && it->is_string()) {
+            CSSParser::collect_variables(it->get_ref<const std::string&>(), component.variables);
+        }
+    }
+    
+    for (const auto& variable : component.variables) {
+        dependents[variable].push_back(component.name);
+    }
+}
+
+std::shared_ptr<const ThemeSnapshot> ThemeSnapshot::load(const std::string& theme_dir,
+                                                         CSSTemplateCache& cache,
+                                                         CSSParser& parser,
+                                                         const ThemeSnapshot* previous) {
+    std::string config_path = theme_dir + "/theme.json";
+    std::ifstream file(config_path);
+    
+    if (!file) {
+        std::cerr << "No se pudo abrir " << config_path << std::endl;
+        return nullptr;
+    }
+    
+    auto snapshot = std::make_shared<ThemeSnapshot>();
+    try {
+        nlohmann::json theme_config;
+        file >> theme_config;
+        
+        if (theme_config.contains("global") && theme_config["global"].is_object()) {
+            snapshot->global_vars = theme_config["global"];
+        } else {
+            snapshot->global_vars = nlohmann::json::object();
+        }
+        
+        if (!theme_config.contains("components") || !theme_config["components"].is_object()) {
+            std::cerr << "No se encontró la sección 'components' en theme.json" << std::endl;
+            return nullptr;
+        }
+        
+        // Componentes afectados por las variables que cambiaron, según el
+        // índice inverso del tema anterior
+        std::unordered_set<std::string> affected;
+        if (previous) {
+            for (const auto& variable : diff_variables(previous->global_vars, snapshot->global_vars)) {
+                auto it = previous->dependents.find(variable);
+                if (it != previous->dependents.end()) {
+                    affected.insert(it->second.begin(), it->second.end());
+                }
+            }
+        }
+        
+        for (auto& [component_name, css_file] : theme_config["components"].items()) {
+            if (!css_file.is_string()) {
+                std::cerr << "Entrada inválida para el componente " << component_name << std::endl;
+                continue;
+            }
+            
+            Component component;
+            component.name = component_name;
+            component.css_path = theme_dir + "/" + css_file.get<std::string>();
+            component.tmpl = cache.get(component.css_path);
+            const Component* old = previous ? previous->find_component(component_name) : nullptr;
+            if (!component.tmpl) {
+                // Archivo ilegible (p. ej. a medio guardar): se conserva el
+                // componente anterior; sin él, el tema estaría incompleto
+                if (!old || old->css_path != component.css_path) {
+                    std::cerr << "No se pudo leer " << component.css_path << ", se mantiene el tema anterior" << std::endl;
+                    return nullptr;
+                }
+                component = *old;
+                snapshot->index_component(component);
+                // El CSS anterior se generó con las variables viejas: si alguna
+                // de las que usa cambió, se vuelve a renderizar la plantilla
+                // anterior con las nuevas
+                if (affected.count(component.name) > 0) {
+                    component.css = parser.scope(parser.render(*component.tmpl, snapshot->global_vars),
+                                                 component.name);
+                    snapshot->changed_components.push_back(component.name);
+                }
+                snapshot->components.push_back(std::move(component));
+                continue;
+            }
+            snapshot->index_component(component);
+            
+            // Reutilizar el CSS anterior si ni la plantilla ni sus variables cambiaron
+            bool dirty = !old || old->css_path != component.css_path || old->tmpl != component.tmpl ||
+                         affected.count(component.name) > 0;
+            
+            if (dirty) {
+                component.css = parser.scope(parser.render(*component.tmpl, snapshot->global_vars),
+                                             component.name);
+                snapshot->changed_components.push_back(component.name);
+            } else {
+                component.css = old->css;
+            }
+            snapshot->components.push_back(std::move(component));
+        }
+        
+        // Componentes que desaparecieron de theme.json también cuentan como cambio
+        if (previous) {
+            for (const auto& old : previous->components) {
+                if (!snapshot->find_component(old.name)) {
+                    snapshot->changed_components.push_back(old.name);
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error leyendo " << config_path << ": " << e.what() << std::endl;
+        return nullptr;
+    }
+    
+    return snapshot;
+}
+
+std::shared_ptr<const ThemeSnapshot> ThemeSnapshot::with_components(const ThemeSnapshot& base,
+                                                                    const std::vector<std::string>& names,
+                                                                    CSSTemplateCache& cache,
+                                                                    CSSParser& parser) {
+    auto snapshot = std::make_shared<ThemeSnapshot>();
+    snapshot->global_vars = base.global_vars;
+    
+    for (const auto& old : base.components) {
+        Component component = old;
+        
+        if (contains(names, component.name)) {
+            auto tmpl = cache.get(component.css_path);
+            // Se conserva el CSS anterior si el archivo desapareció a medio guardar
+            if (tmpl && tmpl != component.tmpl) {
+                component.tmpl = tmpl;
+                component.css = parser.scope(parser.render(*tmpl, snapshot->global_vars), component.name);
+                if (component.css != old.css) {
+                    snapshot->changed_components.push_back(component.name);
+                }
+            }
+        }
+        
+        snapshot->index_component(component);
+        snapshot->components.push_back(std::move(component));
+    }
+    
+    return snapshot;
+}
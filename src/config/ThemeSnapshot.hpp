@@ -0,0 +1,51 @@
+// ThemeSnapshot.hpp
+#pragma once
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../utils/CSSParser.hpp"
+#include "../utils/CSSTemplateCache.hpp"
+
+// Estado inmutable de un tema: variables globales y CSS ya procesado de cada
+// componente. Se construye entero (normalmente en un hilo de trabajo) y solo
+// se publica si es válido, así los widgets nunca ven un tema a medias.
+struct ThemeSnapshot {
+    struct Component {
+        std::string name;
+        std::string css_path;
+        std::string css;            // CSS ya sustituido y limitado a .<name>
+        std::shared_ptr<const CSSTemplate> tmpl;
+        std::vector<std::string> variables; // Variables de las que depende (transitivo)
+    };
+
+    nlohmann::json global_vars;
+    std::vector<Component> components;   // En el orden de theme.json
+
+    // Índice inverso: variable global -> componentes que la usan
+    std::unordered_map<std::string, std::vector<std::string>> dependents;
+
+    // Componentes cuyo CSS cambió respecto al tema anterior
+    std::vector<std::string> changed_components;
+
+    const Component* find_component(const std::string& name) const;
+
+    // Lee theme.json una sola vez y procesa los componentes. Con previous,
+    // solo se vuelven a renderizar los componentes afectados por variables o
+    // archivos que cambiaron. Devuelve nullptr si theme.json no es válido.
+    static std::shared_ptr<const ThemeSnapshot> load(const std::string& theme_dir,
+                                                     CSSTemplateCache& cache,
+                                                     CSSParser& parser,
+                                                     const ThemeSnapshot* previous = nullptr);
+
+    // Copia de base con los componentes indicados vueltos a procesar desde
+    // disco, sin volver a leer theme.json.
+    static std::shared_ptr<const ThemeSnapshot> with_components(const ThemeSnapshot& base,
+                                                                const std::vector<std::string>& names,
+                                                                CSSTemplateCache& cache,
+                                                                CSSParser& parser);
+
+private:
+    void index_component(Component& component);
+};
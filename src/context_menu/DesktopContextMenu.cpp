@@ -1,77 +1,231 @@
 // DesktopContextMenu.cpp
 #include "DesktopContextMenu.hpp"
+#include "../core/Tracer.hpp"
 #include <iostream>
 
 
-DesktopContextMenu::DesktopContextMenu()
-    : menu_box(Gtk::Orientation::VERTICAL) {
+DesktopContextMenu::DesktopContextMenu(IconService& icon_service)
+    : menu_box(Gtk::Orientation::VERTICAL),
+      static_box(Gtk::Orientation::VERTICAL),
+      dynamic_separator(Gtk::Orientation::HORIZONTAL),
+      dynamic_box(Gtk::Orientation::VERTICAL),
+      icon_service(icon_service) {
+    add_css_class("desktop-context-menu");
     set_child(menu_box);
     menu_box.set_margin(10);
     menu_box.set_spacing(5);
+    static_box.set_spacing(5);
+    dynamic_box.set_spacing(5);
+    
+    // Items fijos arriba; los de los proveedores debajo, según van llegando
+    menu_box.append(static_box);
+    menu_box.append(dynamic_separator);
+    menu_box.append(dynamic_box);
+    dynamic_separator.set_visible(false);
+    
     set_autohide(true);
     set_has_arrow(false);
+    
+    action_group = Gio::SimpleActionGroup::create();
+    insert_action_group("menu", action_group);
+    
+    provider_ready.open("menu_provider_ready", [this](const ProviderResult& result) { on_provider_ready(result); });
+}
+
+DesktopContextMenu::~DesktopContextMenu() {
+    for (auto& slot : providers) {
+        {
+            std::lock_guard<std::mutex> lock(slot->mutex);
+            slot->stopping = true;
+        }
+        slot->wake.notify_one();
+    }
+    for (auto& slot : providers) {
+        slot->worker.join();
+    }
+    provider_ready.close();
 }
 
 void DesktopContextMenu::add_item(const MenuItem& item) {
-    items.push_back(item);
+    items.push_back({item, nullptr});
+    menu_dirty = true;
+}
+
+void DesktopContextMenu::add_provider(const MenuProvider& provider) {
+    auto slot = std::make_unique<ProviderSlot>();
+    slot->provider = provider;
+    
+    // Una sección por proveedor: el orden no depende de quién responde antes
+    slot->section = Gtk::make_managed<Gtk::Box>(Gtk::Orientation::VERTICAL, 5);
+    dynamic_box.append(*slot->section);
+    
+    size_t index = providers.size();
+    slot->worker = std::thread(&DesktopContextMenu::provider_loop, this, slot.get(), index);
+    providers.push_back(std::move(slot));
 }
 
-void DesktopContextMenu::setup_menu() { 
-    // Limpiar widgets existentes usando el método correcto de GTK4
-    auto child = menu_box.get_first_child();
-    while (child) {
-        auto next = child->get_next_sibling();
-        menu_box.remove(*child);
-        child = next;
+Gtk::Button* DesktopContextMenu::create_button(const MenuItem& item, const std::string& action_name) {
+    auto button = Gtk::make_managed<Gtk::Button>();
+    configure_button(*button, item);
+    button->set_action_name("menu." + action_name);
+    return button;
+}
+
+void DesktopContextMenu::configure_button(Gtk::Button& button, const MenuItem& item) {
+    if (!item.icon_name.empty()) {
+        auto image = Gtk::make_managed<Gtk::Image>();
+        icon_service.load_into(*image, item.icon_name, 16);
+        button.set_child(*image);
+        button.set_tooltip_text(item.label);
+    } else {
+        button.set_label(item.label);
+        button.set_has_tooltip(false);
     }
+}
 
-    // Crear nuevos widgets usando make_managed para gestión automática
-    for (const auto& item : items) {
-        auto button = Gtk::make_managed<Gtk::Button>();
-        
-        if (!item.icon_name.empty()) {
-            auto icon = Gio::ThemedIcon::create(item.icon_name);
-            auto image = Gtk::make_managed<Gtk::Image>(icon);
-            button->set_child(*image);
-            button->set_tooltip_text(item.label);
-        } else {
-            button->set_label(item.label);
+void DesktopContextMenu::sync_menu() {
+    // Solo se crean los botones de los items nuevos; los demás se reutilizan
+    for (size_t i = 0; i < items.size(); ++i) {
+        auto& entry = items[i];
+        if (entry.button) {
+            continue;
         }
         
-        // Capturar 'this' de forma segura
-        button->signal_clicked().connect([this, item]() {
-            item.action();
-            popdown();
+        std::string action_name = "item-" + std::to_string(i);
+        auto action = Gio::SimpleAction::create(action_name);
+        action->signal_activate().connect([this, i](const Glib::VariantBase&) {
+            on_item_activated(i);
         });
+        action_group->add_action(action);
         
-        menu_box.append(*button);
+        entry.button = create_button(entry.item, action_name);
+        static_box.append(*entry.button);
+    }
+    menu_dirty = false;
+}
+
+void DesktopContextMenu::on_item_activated(size_t index) {
+    if (index < items.size() && items[index].item.action) {
+        items[index].item.action();
     }
+    popdown();
 }
 
 void DesktopContextMenu::show_at_position(double x, double y) {
-    setup_menu();
+    TraceSpan span("DesktopContextMenu::show_at_position");
+    if (menu_dirty) {
+        sync_menu();
+    }
+    request_providers();
     Gdk::Rectangle rect(static_cast<int>(x), static_cast<int>(y), 1, 1);
     set_pointing_to(rect);
     popup();
 }
 
-void DesktopContextMenu::set_parent_widget(Gtk::Widget* parent) {
-    if (parent) {
-        set_parent(*parent);
+void DesktopContextMenu::request_providers() {
+    ++popup_generation;
+    popup_started_us = g_get_monotonic_time();
+    
+    // Lo del popup anterior no se muestra hasta que el proveedor responda;
+    // sus botones se conservan por si la respuesta es la misma
+    for (size_t i = 0; i < providers.size(); ++i) {
+        auto& slot = *providers[i];
+        slot.section->set_visible(false);
+        {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            slot.requested = popup_generation;
+        }
+        slot.wake.notify_one();
     }
+    update_separator();
 }
 
-void DesktopContextMenu::apply_theme(ThemeManager* theme) {
-    auto context = get_style_context();
+void DesktopContextMenu::provider_loop(ProviderSlot* slot, size_t index) {
+    uint64_t served = 0;
+    while (true) {
+        uint64_t generation = 0;
+        {
+            std::unique_lock<std::mutex> lock(slot->mutex);
+            slot->wake.wait(lock, [slot, served]() { return slot->stopping || slot->requested != served; });
+            if (slot->stopping) {
+                return;
+            }
+            // Si hubo varios popups mientras trabajaba, solo importa el último
+            generation = served = slot->requested;
+        }
+        
+        ProviderResult result{index, generation, {}};
+        {
+            TraceSpan span("DesktopContextMenu::provider");
+            result.items = slot->provider.provide();
+        }
+        provider_ready.post(std::move(result));
+    }
+}
+
+void DesktopContextMenu::on_provider_ready(const ProviderResult& result) {
+    if (result.generation != popup_generation || result.provider >= providers.size()) {
+        return;
+    }
+    auto& slot = *providers[result.provider];
     
-    // Limpiar proveedor anterior si existe
-    if (current_provider) {
-        context->remove_provider(current_provider);
+    // Fuera de presupuesto: el menú ya se ve y no debe cambiar de tamaño
+    int64_t elapsed_us = g_get_monotonic_time() - popup_started_us;
+    if (elapsed_us > PROVIDER_BUDGET_US || !get_visible()) {
+        ++slot.dropped;
+        std::cerr << "Proveedor de menú '" << slot.provider.name << "' descartado: "
+                  << elapsed_us / 1000.0 << " ms" << std::endl;
+        return;
     }
     
-    // Obtener proveedor específico para desktop-context-menu
-    current_provider = theme->get_component_provider("desktop-context-menu");
-    if (current_provider) {
-        context->add_provider(current_provider, GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+    // Un botón que ya muestra lo mismo se conserva tal cual; su acción lee
+    // slot.items al activarse, así basta con sustituir los items
+    const auto& fresh = result.items;
+    for (size_t i = 0; i < fresh.size(); ++i) {
+        if (i < slot.buttons.size()) {
+            if (slot.items[i].label != fresh[i].label || slot.items[i].icon_name != fresh[i].icon_name) {
+                configure_button(*slot.buttons[i], fresh[i]);
+            }
+            continue;
+        }
+        std::string action_name = provider_action(result.provider, i);
+        auto action = Gio::SimpleAction::create(action_name);
+        action->signal_activate().connect([this, &slot, i](const Glib::VariantBase&) {
+            // Copia: la acción puede abrir otro popup y reemplazar los items
+            auto action = i < slot.items.size() ? slot.items[i].action : nullptr;
+            popdown();
+            if (action) {
+                action();
+            }
+        });
+        action_group->add_action(action);
+        slot.buttons.push_back(create_button(fresh[i], action_name));
+        slot.section->append(*slot.buttons.back());
+    }
+    while (slot.buttons.size() > fresh.size()) {
+        action_group->remove_action(provider_action(result.provider, slot.buttons.size() - 1));
+        slot.section->remove(*slot.buttons.back());
+        slot.buttons.pop_back();
     }
-}
\ No newline at end of file
+    slot.items = fresh;
+    slot.section->set_visible(true);
+    update_separator();
+}
+
+std::string DesktopContextMenu::provider_action(size_t provider, size_t item) {
+    return "provider-" + std::to_string(provider) + "-" + std::to_string(item);
+}
+
+void DesktopContextMenu::update_separator() {
+    bool any = false;
+    for (const auto& slot : providers) {
+        any = any || (slot->section->get_visible() && !slot->items.empty());
+    }
+    dynamic_separator.set_visible(any);
+}
+
+void DesktopContextMenu::set_parent_widget(Gtk::Widget* parent) {
+    if (parent) {
+        set_parent(*parent);
+    }
+}
@@ -1,10 +1,15 @@
 // DesktopContextMenu.hpp
 #pragma once
 #include <gtkmm.h>
+#include <condition_variable>
+#include <cstdint>
 #include <vector>
 #include <functional>
 #include <memory>
-#include "../config/ThemeManager.hpp"
+#include <mutex>
+#include <thread>
+#include "../core/EventManager.hpp"
+#include "../core/IconService.hpp"
 
 struct MenuItem {
     std::string label;
@@ -12,22 +17,78 @@ struct MenuItem {
     std::string icon_name = "";
 };
 
+// Fuente de items dinámicos ("abrir terminal aquí", fondos recientes...).
+// provide se llama en un hilo de trabajo en cada popup; las acciones de los
+// items devueltos se ejecutan en el hilo principal.
+struct MenuProvider {
+    std::string name;
+    std::function<std::vector<MenuItem>()> provide;
+};
+
 class DesktopContextMenu : public Gtk::Popover {
 public:
-    DesktopContextMenu();
-    ~DesktopContextMenu() = default;
+    // Tiempo que un proveedor tiene para responder tras el clic derecho
+    static constexpr int64_t PROVIDER_BUDGET_US = 50000;
+
+    DesktopContextMenu(IconService& icon_service);
+    ~DesktopContextMenu();
     
+    // Marca el menú como sucio; los botones se crean en el siguiente popup
     void add_item(const MenuItem& item);
+    // Cada proveedor tiene su propio hilo: uno lento no retrasa a los demás
+    void add_provider(const MenuProvider& provider);
     void show_at_position(double x, double y);
     void set_parent_widget(Gtk::Widget* parent);
 
-    void apply_theme(ThemeManager* theme);
-
 private:
-    Gtk::Box menu_box;
-    std::vector<MenuItem> items;
+    // Los botones se conservan entre popups; cada uno activa "menu.item-N"
+    struct Entry {
+        MenuItem item;
+        Gtk::Button* button = nullptr;   // Gestionado por static_box
+    };
 
-    Glib::RefPtr<Gtk::CssProvider> current_provider;
+    // Proveedor con su hilo; requested avanza con cada popup
+    struct ProviderSlot {
+        MenuProvider provider;
+        Gtk::Box* section = nullptr;     // Gestionado por dynamic_box
+        std::vector<MenuItem> items;     // Items de la última respuesta mostrada
+        std::vector<Gtk::Button*> buttons;  // Uno por item; se reutilizan entre popups
+        uint64_t dropped = 0;            // Respuestas fuera de presupuesto
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable wake;
+        uint64_t requested = 0;
+        bool stopping = false;
+    };
+
+    // Respuesta de un proveedor; llega por provider_ready
+    struct ProviderResult {
+        size_t provider;
+        uint64_t generation;
+        std::vector<MenuItem> items;
+    };
+
+    Gtk::Box menu_box;
+    Gtk::Box static_box;
+    Gtk::Separator dynamic_separator;
+    Gtk::Box dynamic_box;
+    std::vector<Entry> items;
+    Glib::RefPtr<Gio::SimpleActionGroup> action_group;
+    IconService& icon_service;
+    bool menu_dirty = false;
     
-    void setup_menu();
-};
\ No newline at end of file
+    std::vector<std::unique_ptr<ProviderSlot>> providers;
+    uint64_t popup_generation = 0;
+    int64_t popup_started_us = 0;
+    WorkerResults<ProviderResult> provider_ready;
+    
+    void sync_menu();
+    void on_item_activated(size_t index);
+    Gtk::Button* create_button(const MenuItem& item, const std::string& action_name);
+    void configure_button(Gtk::Button& button, const MenuItem& item);
+    void request_providers();
+    void provider_loop(ProviderSlot* slot, size_t index);
+    void on_provider_ready(const ProviderResult& result);
+    static std::string provider_action(size_t provider, size_t item);
+    void update_separator();
+};
@@ -0,0 +1,252 @@
+// ControlServer.cpp
+#include "ControlServer.hpp"
+#include <glib-unix.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+ControlServer::ControlServer(const std::string& socket_path) : path_(socket_path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path_.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Ruta del socket de control demasiado larga: " << path_ << std::endl;
+        return;
+    }
+    std::memcpy(address.sun_path, path_.c_str(), path_.size() + 1);
+    
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "No se pudo crear el socket de control: " << std::strerror(errno) << std::endl;
+        return;
+    }
+    
+    // Un socket que quedó de una ejecución anterior impediría el bind; el de
+    // una instancia en marcha se respeta
+    if (is_in_use(address)) {
+        std::cerr << "Otra instancia ya atiende en " << path_ << "; sin socket de control" << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return;
+    }
+    
+    // Solo el usuario de la sesión. En Linux el modo del socket antes de
+    // bind pasa al archivo; umask no se toca porque afecta a todos los hilos
+    fchmod(listen_fd_, 0600);
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_fd_, 8) != 0) {
+        std::cerr << "No se pudo escuchar en " << path_ << ": " << std::strerror(errno) << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return;
+    }
+    
+    listen_source_ = g_unix_fd_add(listen_fd_, G_IO_IN, &ControlServer::on_accept, this);
+    std::cout << "Socket de control en " << path_ << std::endl;
+}
+
+ControlServer::~ControlServer() {
+    while (!clients_.empty()) {
+        close_client(clients_.begin()->first);
+    }
+    if (listen_source_ != 0) {
+        g_source_remove(listen_source_);
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        unlink(path_.c_str());
+    }
+}
+
+bool ControlServer::is_in_use(const sockaddr_un& address) {
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe < 0) {
+        return false;
+    }
+    bool in_use = true;
+    if (connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        if (errno == ECONNREFUSED) {
+            // Nadie escucha: restos de una ejecución que terminó mal
+            unlink(address.sun_path);
+            in_use = false;
+        } else {
+            // ENOENT: no hay socket. Cualquier otro error lo dirá bind
+            in_use = false;
+        }
+    }
+    close(probe);
+    return in_use;
+}
+
+void ControlServer::add_command(const std::string& name, Handler handler) {
+    commands_[name] = std::move(handler);
+}
+
+void ControlServer::append_metric(std::string& out, const char* name, double value, const std::string& labels) {
+    size_t length = std::strlen(name);
+    bool counter = length > 6 && std::strcmp(name + length - 6, "_total") == 0;
+    append_type(out, name, counter ? "counter" : "gauge");
+    append_sample(out, name, value, labels);
+}
+
+void ControlServer::append_type(std::string& out, const char* name, const char* type) {
+    // Las series con etiquetas repiten nombre: el tipo solo va una vez
+    std::string line = std::string("# TYPE ") + name + " ";
+    if (out.find(line) != std::string::npos) {
+        return;
+    }
+    out.append(line).append(type).append("\n");
+}
+
+void ControlServer::append_sample(std::string& out, const char* name, double value, const std::string& labels) {
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.17g", value);
+    out.append(name);
+    if (!labels.empty()) {
+        out.append("{").append(labels).append("}");
+    }
+    out.append(" ").append(number).append("\n");
+}
+
+void ControlServer::append_histogram(std::string& out, const char* name, const Histogram& histogram) {
+    // Cubos acumulados, como espera Prometheus
+    append_type(out, name, "histogram");
+    std::string bucket_name = std::string(name) + "_bucket";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < Histogram::bucket_count(); ++i) {
+        cumulative += histogram.bucket(i);
+        std::string bound = i < Histogram::BOUNDS_US.size() ? std::to_string(Histogram::BOUNDS_US[i]) : "+Inf";
+        append_sample(out, bucket_name.c_str(), static_cast<double>(cumulative), "le=\"" + bound + "\"");
+    }
+    append_sample(out, (std::string(name) + "_sum").c_str(), static_cast<double>(histogram.sum_us()), "");
+    append_sample(out, (std::string(name) + "_count").c_str(), static_cast<double>(histogram.count()), "");
+}
+
+gboolean ControlServer::on_accept(gint fd, GIOCondition /*condition*/, gpointer data) {
+    auto* self = static_cast<ControlServer*>(data);
+    while (true) {
+        int client_fd = accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_fd < 0) {
+            break;      // EAGAIN: no quedan conexiones pendientes
+        }
+        if (self->clients_.size() >= MAX_CLIENTS) {
+            close(client_fd);
+            continue;
+        }
+        auto client = std::make_unique<Client>();
+        client->server = self;
+        client->fd = client_fd;
+        client->source = g_unix_fd_add(client_fd, G_IO_IN, &ControlServer::on_client_io, self);
+        client->timeout = g_timeout_add_seconds(CLIENT_TIMEOUT_S, &ControlServer::on_client_timeout, client.get());
+        self->clients_[client_fd] = std::move(client);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+gboolean ControlServer::on_client_io(gint fd, GIOCondition /*condition*/, gpointer data) {
+    auto* self = static_cast<ControlServer*>(data);
+    auto it = self->clients_.find(fd);
+    if (it == self->clients_.end()) {
+        return G_SOURCE_REMOVE;
+    }
+    Client& client = *it->second;
+    
+    if (!client.writing) {
+        char buffer[1024];
+        ssize_t length = read(fd, buffer, sizeof(buffer));
+        if (length < 0 && (errno == EAGAIN || errno == EINTR)) {
+            return G_SOURCE_CONTINUE;
+        }
+        if (length > 0) {
+            client.input.append(buffer, length);
+        }
+        
+        size_t newline = client.input.find('\n');
+        bool finished = newline != std::string::npos || length == 0;
+        if (length < 0 || client.input.size() > MAX_REQUEST || (length == 0 && client.input.empty())) {
+            client.source = 0;
+            self->close_client(fd);
+            return G_SOURCE_REMOVE;
+        }
+        if (!finished) {
+            return G_SOURCE_CONTINUE;
+        }
+        
+        std::string line = client.input.substr(0, newline);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        client.output = self->run_command(line);
+        client.writing = true;
+    }
+    
+    // MSG_NOSIGNAL: un cliente que cierra antes de tiempo no debe provocar SIGPIPE
+    while (client.written < client.output.size()) {
+        ssize_t sent = send(fd, client.output.data() + client.written,
+                            client.output.size() - client.written, MSG_NOSIGNAL);
+        if (sent < 0 && (errno == EAGAIN || errno == EINTR)) {
+            // Respuesta grande: seguir cuando el socket admita más datos
+            if (!client.watching_output) {
+                client.watching_output = true;
+                client.source = g_unix_fd_add(fd, G_IO_OUT, &ControlServer::on_client_io, self);
+                return G_SOURCE_REMOVE;
+            }
+            return G_SOURCE_CONTINUE;
+        }
+        if (sent < 0) {
+            break;
+        }
+        client.written += sent;
+    }
+    
+    client.source = 0;
+    self->close_client(fd);
+    return G_SOURCE_REMOVE;
+}
+
+gboolean ControlServer::on_client_timeout(gpointer data) {
+    auto* client = static_cast<Client*>(data);
+    client->timeout = 0;
+    client->server->close_client(client->fd);
+    return G_SOURCE_REMOVE;
+}
+
+std::string ControlServer::run_command(const std::string& line) {
+    size_t space = line.find(' ');
+    std::string name = line.substr(0, space);
+    std::string args = space == std::string::npos ? "" : line.substr(space + 1);
+    
+    auto it = commands_.find(name);
+    if (it == commands_.end()) {
+        std::string reply = "error: orden desconocida '" + name + "'. Órdenes:";
+        for (const auto& [command, handler] : commands_) {
+            reply += " " + command;
+        }
+        return reply + "\n";
+    }
+    
+    std::string reply = it->second(args);
+    if (reply.empty() || reply.back() != '\n') {
+        reply.push_back('\n');
+    }
+    return reply;
+}
+
+void ControlServer::close_client(int fd) {
+    auto it = clients_.find(fd);
+    if (it == clients_.end()) {
+        return;
+    }
+    if (it->second->source != 0) {
+        g_source_remove(it->second->source);
+    }
+    if (it->second->timeout != 0) {
+        g_source_remove(it->second->timeout);
+    }
+    close(fd);
+    clients_.erase(it);
+}
@@ -0,0 +1,73 @@
+// ControlServer.hpp
+#pragma once
+#include <glib.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <sys/un.h>
+#include "../utils/Histogram.hpp"
+
+// Socket Unix local para consultar métricas y dar órdenes al escritorio en
+// marcha. Se atiende desde el bucle principal de GLib (g_unix_fd_add), sin
+// hilos. Protocolo de texto: una línea "orden [argumentos]" por conexión; la
+// respuesta se escribe y se cierra la conexión. Si otra instancia ya atiende
+// en la misma ruta, esta no escucha.
+//
+//   echo metrics | socat - UNIX-CONNECT:$XDG_RUNTIME_DIR/entorno.sock
+class ControlServer {
+public:
+    // Recibe el resto de la línea tras el nombre de la orden; devuelve la respuesta
+    using Handler = std::function<std::string(const std::string& args)>;
+
+    explicit ControlServer(const std::string& socket_path);
+    ~ControlServer();
+
+    bool is_listening() const { return listen_fd_ >= 0; }
+    const std::string& get_path() const { return path_; }
+
+    void add_command(const std::string& name, Handler handler);
+
+    // Formato de texto de Prometheus. El tipo (# TYPE) se declara la primera
+    // vez que aparece cada nombre: counter si termina en _total, si no gauge
+    static void append_metric(std::string& out, const char* name, double value,
+                              const std::string& labels = "");
+    static void append_histogram(std::string& out, const char* name, const Histogram& histogram);
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+private:
+    static constexpr size_t MAX_REQUEST = 4096;
+    static constexpr size_t MAX_CLIENTS = 16;
+    // Un cliente que no envía la petición o no lee la respuesta se cierra
+    static constexpr guint CLIENT_TIMEOUT_S = 5;
+
+    struct Client {
+        ControlServer* server = nullptr;
+        int fd = -1;
+        guint source = 0;
+        guint timeout = 0;
+        bool writing = false;           // Petición leída, respuesta en curso
+        bool watching_output = false;   // source vigila G_IO_OUT en vez de G_IO_IN
+        std::string input;
+        std::string output;
+        size_t written = 0;
+    };
+
+    static gboolean on_accept(gint fd, GIOCondition condition, gpointer data);
+    static gboolean on_client_io(gint fd, GIOCondition condition, gpointer data);
+    static gboolean on_client_timeout(gpointer data);
+    static bool is_in_use(const sockaddr_un& address);
+    static void append_type(std::string& out, const char* name, const char* type);
+    static void append_sample(std::string& out, const char* name, double value, const std::string& labels);
+    std::string run_command(const std::string& line);
+    void close_client(int fd);
+
+    std::string path_;
+    int listen_fd_ = -1;
+    guint listen_source_ = 0;
+    std::map<std::string, Handler> commands_;
+    std::map<int, std::unique_ptr<Client>> clients_;
+};
@@ -1,7 +1,16 @@
 // CoreSystem.cpp
 #include "CoreSystem.hpp"
+#include <glib-unix.h>
+#include <algorithm>
+#include <csignal>
+#include <filesystem>
 #include <iostream>
-#include "EventManager.hpp"
+#include "Events.hpp"
+#include "Tracer.hpp"
+#include "../utils/ProcessStats.hpp"
+#include <sstream>
+
+namespace fs = std::filesystem;
 
 CoreSystem::CoreSystem(const std::string& theme_path) 
     : theme_path(theme_path) {}   
@@ -11,98 +20,313 @@ CoreSystem::~CoreSystem() {
 }
 
 void CoreSystem::start(Glib::RefPtr<Gtk::Application> app) {
+    TraceSpan span("CoreSystem::start");
     this->app = app;
+    timeline.mark("activate");
+    
+    // Volcado de trazas bajo demanda: kill -USR2 <pid>
+    if (Tracer::enabled()) {
+        Tracer::get_instance().set_thread_name("main");
+        trace_signal_source = g_unix_signal_add(SIGUSR2, [](gpointer) -> gboolean {
+            Tracer::get_instance().dump();
+            return G_SOURCE_CONTINUE;
+        }, nullptr);
+    }
+    
+    // SIGTERM/SIGINT cierran la aplicación con normalidad: run() vuelve y
+    // main() puede volcar las trazas antes de salir
+    quit_signal_sources[0] = g_unix_signal_add(SIGTERM, &CoreSystem::on_quit_signal, this);
+    quit_signal_sources[1] = g_unix_signal_add(SIGINT, &CoreSystem::on_quit_signal, this);
+    
+    // Etapa visible: tema, color de fondo y panel. La imagen del fondo se
+    // decodifica en segundo plano; mientras tanto se ve el color del tema
     theme = std::make_unique<ThemeManager>(theme_path); // Usamos theme sin guión bajo
+    timeline.mark("theme_loaded");
+    theme_reloaded_connection = theme->signal_reloaded().connect(
+        [this](const std::vector<std::string>&) { watch_restyle(); });
+    
+    wallpaper_loader = std::make_unique<WallpaperLoader>();
+    icon_service = std::make_unique<IconService>();
+    app_spawner = std::make_unique<AppSpawner>();
+    timer_wheel = std::make_unique<TimerWheel>();
+    system_monitor = std::make_unique<SystemMonitor>(*timer_wheel);
+    
+    // Rotación de fondos; la siguiente imagen se precarga en segundo plano
+    slideshow = std::make_unique<WallpaperSlideshow>(*wallpaper_loader, "assets/wallpaper/wallpaperUno.jpg");
+    
+    // El tema se aplica a todo el display con un único proveedor CSS; cada
+    // componente solo declara su clase (.top-panel, .wallpaper-window, ...)
     
-    wallpaper = std::make_unique<WallpaperWindow>("assets/wallpaper/wallpaperUno.jpg");
-    top_panel = std::make_unique<TopPanel>();
-    app_launcher = std::make_unique<AppLauncher>();
-    context_menu = std::make_unique<DesktopContextMenu>();
+    // Un fondo y un panel por monitor, actualizados al conectar/desconectar
+    sync_monitors();
+    auto display = Gdk::Display::get_default();
+    if (display) {
+        monitors_connection = display->get_monitors()->signal_items_changed().connect(
+            [this](guint, guint, guint) { sync_monitors(); });
+    }
+    timeline.mark("panels_shown");
+    
+    // Volcado de la línea de tiempo bajo demanda: kill -USR1 <pid>
+    dump_signal_source = g_unix_signal_add(SIGUSR1, &CoreSystem::on_dump_signal, this);
+
+    // Lo oculto se construye después del primer frame del panel
+    if (outputs.empty()) {
+        queue_deferred_stages();
+    } else {
+        outputs.front().top_panel->add_tick_callback([this](const Glib::RefPtr<Gdk::FrameClock>&) {
+            timeline.mark("first_frame");
+            queue_deferred_stages();
+            return false;
+        });
+    }
+}
+
+void CoreSystem::queue_deferred_stages() {
+    startup_stages.push_back([this]() {
+        TraceSpan span("CoreSystem::build_launcher");
+        app_launcher = std::make_unique<AppLauncher>(*icon_service, *app_spawner);
+        app->add_window(*app_launcher);
+        // Superficie creada de antemano: la primera apertura no la paga
+        app_launcher->realize();
+        for (auto& output : outputs) {
+            output.top_panel->set_app_launcher(app_launcher.get());
+        }
+        timeline.mark("launcher_built");
+    });
+    
+    startup_stages.push_back([this]() {
+        TraceSpan span("CoreSystem::build_context_menu");
+        context_menu = std::make_unique<DesktopContextMenu>(*icon_service);
+        if (!outputs.empty()) {
+            context_menu->set_parent(*outputs.front().wallpaper);
+        }
+        setup_context_menu();
+        timeline.mark("context_menu_built");
+    });
+    
+    startup_stages.push_back([this]() {
+        TraceSpan span("CoreSystem::start_slideshow");
+        slideshow->set_directory("assets/wallpaper");
+        slideshow->start(300);
+        timeline.mark("slideshow_started");
+    });
+    
+    startup_stages.push_back([this]() {
+        setup_control_server();
+        timeline.mark("control_server_ready");
+    });
+    
+    // Prioridad idle: entre etapa y etapa se atienden la entrada y los frames
+    startup_idle = Glib::signal_idle().connect(sigc::mem_fun(*this, &CoreSystem::run_next_stage),
+                                               Glib::PRIORITY_DEFAULT_IDLE);
+}
+
+bool CoreSystem::run_next_stage() {
+    if (startup_stages.empty()) {
+        return false;
+    }
+    auto stage = std::move(startup_stages.front());
+    startup_stages.pop_front();
+    stage();
+    
+    if (startup_stages.empty()) {
+        timeline.mark("startup_complete");
+        timeline.dump(std::cout);
+        return false;
+    }
+    return true;
+}
+
+gboolean CoreSystem::on_quit_signal(gpointer data) {
+    auto* self = static_cast<CoreSystem*>(data);
+    std::cout << "Señal de salida recibida, cerrando" << std::endl;
+    if (self->app) {
+        self->app->quit();
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+gboolean CoreSystem::on_dump_signal(gpointer data) {
+    auto* self = static_cast<CoreSystem*>(data);
+    self->timeline.dump(std::cout);
+    if (self->timer_wheel) {
+        const auto& stats = self->timer_wheel->get_stats();
+        std::cout << "Temporizadores: " << self->timer_wheel->get_wakeups_per_minute()
+                  << " despertares/min, " << stats.active << " activos, "
+                  << stats.callbacks << " callbacks en " << stats.wakeups << " despertares" << std::endl;
+    }
+    if (self->system_monitor) {
+        std::cout << "Applet de carga: " << self->system_monitor->get_stats().samples << " muestras, "
+                  << self->system_monitor->get_self_cpu_percent() << "% de un núcleo" << std::endl;
+    }
+    return G_SOURCE_CONTINUE;
+}
 
-    context_menu->set_parent(*wallpaper);
-    top_panel->set_app_launcher(app_launcher.get());
+void CoreSystem::sync_monitors() {
+    auto display = Gdk::Display::get_default();
+    if (!display) {
+        return;
+    }
     
-    // Aplicar tema a todos los componentes
-    wallpaper->apply_theme(theme.get());
-    top_panel->apply_theme(theme.get());
-    app_launcher->apply_theme(theme.get());
-    context_menu->apply_theme(theme.get());
+    std::vector<Glib::RefPtr<Gdk::Monitor>> current;
+    auto monitors = display->get_monitors();
+    for (guint i = 0; i < monitors->get_n_items(); ++i) {
+        auto monitor = std::dynamic_pointer_cast<Gdk::Monitor>(monitors->get_object(i));
+        if (monitor) {
+            current.push_back(monitor);
+        }
+    }
     
-    app->add_window(*wallpaper);
-    app->add_window(*top_panel);
-    app->add_window(*app_launcher);
+    // Quitar las salidas de monitores desconectados
+    for (size_t i = outputs.size(); i-- > 0;) {
+        if (std::find(current.begin(), current.end(), outputs[i].monitor) == current.end()) {
+            remove_output(i);
+        }
+    }
     
-    wallpaper->show();
-    top_panel->show();
-    app_launcher->hide();
+    // Crear las de monitores nuevos
+    for (const auto& monitor : current) {
+        auto it = std::find_if(outputs.begin(), outputs.end(),
+                               [&monitor](const MonitorOutput& output) { return output.monitor == monitor; });
+        if (it == outputs.end()) {
+            add_output(monitor);
+        }
+    }
+    
+    // El menú contextual cuelga del fondo del primer monitor
+    if (context_menu && !context_menu->get_parent() && !outputs.empty()) {
+        context_menu->set_parent(*outputs.front().wallpaper);
+    }
+}
+
+void CoreSystem::add_output(const Glib::RefPtr<Gdk::Monitor>& monitor) {
+    MonitorOutput output;
+    output.monitor = monitor;
+    // Monitores del mismo tamaño comparten la textura decodificada (WallpaperLoader)
+    output.wallpaper = std::make_unique<WallpaperWindow>(slideshow->get_current_wallpaper(),
+                                                         *wallpaper_loader, monitor);
+    output.top_panel = std::make_unique<TopPanel>(monitor, *icon_service, *timer_wheel, *system_monitor);
+    output.top_panel->set_app_launcher(app_launcher.get());
+    
+    app->add_window(*output.wallpaper);
+    app->add_window(*output.top_panel);
+    output.wallpaper->show();
+    output.top_panel->show();
+    
+    slideshow->add_window(*output.wallpaper);
+    std::cout << "Monitor conectado: " << monitor->get_connector() << std::endl;
+    outputs.push_back(std::move(output));
+}
 
-    setup_context_menu();
+void CoreSystem::remove_output(size_t index) {
+    auto& output = outputs[index];
+    std::cout << "Monitor desconectado: " << output.monitor->get_connector() << std::endl;
+    
+    if (context_menu && context_menu->get_parent() == output.wallpaper.get()) {
+        context_menu->unparent();
+    }
+    if (slideshow) {
+        slideshow->remove_window(*output.wallpaper);
+    }
+    if (app) {
+        app->remove_window(*output.top_panel);
+        app->remove_window(*output.wallpaper);
+    }
+    outputs.erase(outputs.begin() + index);
 }
 
 void CoreSystem::stop() {
+    startup_idle.disconnect();
+    startup_stages.clear();
+    if (dump_signal_source != 0) {
+        g_source_remove(dump_signal_source);
+        dump_signal_source = 0;
+    }
+    if (trace_signal_source != 0) {
+        g_source_remove(trace_signal_source);
+        trace_signal_source = 0;
+    }
+    for (guint& source : quit_signal_sources) {
+        if (source != 0) {
+            g_source_remove(source);
+            source = 0;
+        }
+    }
+    control_server.reset();
+    right_click_subscription.reset();
+    monitors_connection.disconnect();
+    slideshow.reset();
+    
+    if (context_menu && context_menu->get_parent()) {
+        context_menu->unparent();
+    }
+    while (!outputs.empty()) {
+        remove_output(outputs.size() - 1);
+    }
     if(app) {
-        if(top_panel) app->remove_window(*top_panel);
-        if(wallpaper) app->remove_window(*wallpaper);
         if(app_launcher) app->remove_window(*app_launcher);
     }
 
     context_menu.reset();
     app_launcher.reset();
-    top_panel.reset();
-    wallpaper.reset();
+    app_spawner.reset();
+    icon_service.reset();
+    system_monitor.reset();     // Quita su tick de timer_wheel
+    timer_wheel.reset();
+    wallpaper_loader.reset();
+    theme_reloaded_connection.disconnect();
+    restyle_paint_connection.disconnect();
     theme.reset();
 }
 
 void CoreSystem::reload_theme() {
     if (theme) {
-        theme->reload(); // Recargar el tema
-        
-        // Vuelve a aplicar el tema a todos los componentes
-        wallpaper->apply_theme(theme.get());
-        top_panel->apply_theme(theme.get());
-        app_launcher->apply_theme(theme.get());
-        context_menu->apply_theme(theme.get());
+        // El proveedor compartido se actualiza cuando el tema nuevo esté listo
+        theme->reload();
     }
 }
 
+void CoreSystem::watch_restyle() {
+    if (outputs.empty() || restyle_paint_connection.connected()) {
+        return;
+    }
+    auto clock = outputs.front().top_panel->get_frame_clock();
+    if (!clock) {
+        return;
+    }
+    // after-paint llega cuando GTK ya recalculó estilos, hizo layout y pintó
+    restyle_paint_connection = clock->signal_after_paint().connect([this]() {
+        restyle_paint_connection.disconnect();
+        if (theme) {
+            theme->record_restyle(g_get_monotonic_time());
+        }
+    });
+    clock->request_phase(Gdk::FrameClock::Phase::PAINT);
+}
+
 void CoreSystem::setup_context_menu() {
-    // Registrar evento de clic derecho
-    EventManager::get_instance().register_event("desktop_right_click", [this]() {
-        std::cout << "Evento de clic derecho recibido" << std::endl;
-        
-        // Posición por defecto (centro de la pantalla)
-        double x = 200;
-        double y = 200;
-        
-        // Intentar obtener posición real del cursor
-        auto display = Gdk::Display::get_default();
-        if (display) {
-            auto seat = display->get_default_seat();
-            if (seat) {
-                auto pointer = seat->get_pointer();
-                if (pointer) {
-                    double cursor_x, cursor_y;
-                    auto surface = pointer->get_surface_at_position(cursor_x, cursor_y);
-                    if (surface) {
-                        x = cursor_x;
-                        y = cursor_y;
-                        std::cout << "Posición del cursor: " << x << ", " << y << std::endl;
-                    }
+    // Registrar evento de clic derecho; la posición llega con el evento
+    right_click_subscription = EventManager::get_instance().subscribe(Events::desktop_right_click(),
+        [this](const PointerEvent& event) {
+            std::cout << "Evento de clic derecho recibido en: " << event.x << ", " << event.y << std::endl;
+            
+            // Mostrar el menú sobre el fondo (monitor) que recibió el clic
+            if (event.widget && context_menu->get_parent() != event.widget) {
+                if (context_menu->get_parent()) {
+                    context_menu->unparent();
                 }
+                context_menu->set_parent(*event.widget);
             }
-        }
-        
-        // Mostrar menú en posición calculada
-        context_menu->show_at_position(x, y);
-    });
+            context_menu->show_at_position(event.x, event.y);
+        });
 
     // Añadir items al menú
     context_menu->add_item({
         "Actualizar",
         [this]() {
             std::cout << "Ejecutando acción de actualización" << std::endl;
-            if (wallpaper) {
-                wallpaper->refresh_desktop();
+            for (auto& output : outputs) {
+                output.wallpaper->refresh_desktop();
             }
         },
         "view-refresh-symbolic"
@@ -110,8 +334,10 @@ void CoreSystem::setup_context_menu() {
     
     context_menu->add_item({
         "Cambiar fondo",
-        []() { 
-            std::cout << "Cambiar fondo" << std::endl; 
+        [this]() { 
+            if (slideshow) {
+                slideshow->next();
+            }
         },
         "preferences-desktop-wallpaper-symbolic"
     });
@@ -123,4 +349,154 @@ void CoreSystem::setup_context_menu() {
         },
         "preferences-system-symbolic"
     });
-}
\ No newline at end of file
+    
+    // Items dinámicos: se calculan en hilos de trabajo en cada popup
+    context_menu->add_provider({
+        "terminal",
+        [this]() -> std::vector<MenuItem> {
+            std::vector<std::string> terminal = AppSpawner::terminal_command();
+            std::string dir = Glib::get_user_special_dir(Glib::UserDirectory::DESKTOP);
+            if (dir.empty() || !fs::is_directory(dir)) {
+                dir = Glib::get_home_dir();
+            }
+            return {{
+                "Abrir terminal aquí",
+                [this, terminal, dir]() {
+                    if (!app_spawner->spawn_command(terminal, dir)) {
+                        std::cerr << "No se pudo abrir la terminal " << terminal[0] << std::endl;
+                    }
+                },
+                "utilities-terminal-symbolic"
+            }};
+        }
+    });
+    
+    context_menu->add_provider({
+        "recent_wallpapers",
+        [this]() -> std::vector<MenuItem> {
+            // Los fondos modificados más recientemente
+            std::vector<std::pair<fs::file_time_type, std::string>> images;
+            std::error_code error;
+            for (const auto& file : fs::directory_iterator("assets/wallpaper", error)) {
+                auto extension = file.path().extension().string();
+                if (extension == ".jpg" || extension == ".jpeg" || extension == ".png" || extension == ".webp") {
+                    images.emplace_back(file.last_write_time(error), file.path().string());
+                }
+            }
+            std::sort(images.begin(), images.end(), std::greater<>());
+            
+            std::vector<MenuItem> items;
+            for (size_t i = 0; i < images.size() && i < RECENT_WALLPAPERS; ++i) {
+                std::string path = images[i].second;
+                items.push_back({
+                    fs::path(path).filename().string(),
+                    [this, path]() { set_wallpaper(path); }
+                });
+            }
+            return items;
+        }
+    });
+}
+void CoreSystem::set_wallpaper(const std::string& path) {
+    for (auto& output : outputs) {
+        output.wallpaper->load_wallpaper(path);
+    }
+    // Que la rotación no lo sustituya antes de un intervalo completo
+    if (slideshow) {
+        slideshow->set_current_wallpaper(path);
+    }
+}
+
+void CoreSystem::setup_control_server() {
+    // Uno por sesión: cada usuario (puesto) tiene su propio directorio de ejecución
+    control_server = std::make_unique<ControlServer>(Glib::get_user_runtime_dir() + "/entorno.sock");
+    if (!control_server->is_listening()) {
+        control_server.reset();
+        return;
+    }
+    
+    control_server->add_command("metrics", [this](const std::string&) {
+        return collect_metrics();
+    });
+    control_server->add_command("timeline", [this](const std::string&) {
+        std::ostringstream out;
+        timeline.dump(out);
+        return out.str();
+    });
+    control_server->add_command("reload-theme", [this](const std::string&) -> std::string {
+        reload_theme();
+        return "ok";
+    });
+    control_server->add_command("set-wallpaper", [this](const std::string& path) -> std::string {
+        if (!fs::is_regular_file(path)) {
+            return "error: no existe " + path;
+        }
+        set_wallpaper(path);
+        return "ok";
+    });
+    control_server->add_command("next-wallpaper", [this](const std::string&) -> std::string {
+        if (slideshow) {
+            slideshow->next();
+        }
+        return "ok";
+    });
+    control_server->add_command("dump-trace", [](const std::string&) -> std::string {
+        if (!Tracer::enabled()) {
+            return "error: trazas desactivadas (ENTORNO_TRACE)";
+        }
+        auto& tracer = Tracer::get_instance();
+        return tracer.dump() ? tracer.get_output_path() : "error: no se pudo escribir " + tracer.get_output_path();
+    });
+}
+
+std::string CoreSystem::collect_metrics() {
+    std::string out;
+    
+    if (theme) {
+        const auto& style = theme->get_style_stats();
+        const auto& reloads = theme->get_reload_stats();
+        ControlServer::append_metric(out, "entorno_theme_reloads_total", style.reload_us.count());
+        ControlServer::append_histogram(out, "entorno_theme_reload_duration_us", style.reload_us);
+        ControlServer::append_histogram(out, "entorno_theme_restyle_duration_us", style.restyle_us);
+        ControlServer::append_metric(out, "entorno_theme_css_loads_total", style.loads);
+        ControlServer::append_metric(out, "entorno_theme_css_bytes", style.css_bytes);
+        ControlServer::append_metric(out, "entorno_theme_css_bytes_total", style.css_bytes_total);
+        ControlServer::append_metric(out, "entorno_theme_last_css_load_us", style.last_load_us);
+        ControlServer::append_metric(out, "entorno_theme_file_events_total", reloads.events);
+        ControlServer::append_metric(out, "entorno_theme_file_events_coalesced_total", reloads.coalesced);
+    }
+    
+    auto& events = EventManager::get_instance();
+    for (EventId id = 0; id < events.get_event_count(); ++id) {
+        ControlServer::append_metric(out, "entorno_events_dispatched_total", events.get_dispatch_count(id),
+                                     "event=\"" + events.get_name(id) + "\"");
+    }
+    const auto& posts = events.get_post_stats();
+    ControlServer::append_metric(out, "entorno_events_posted_total", posts.posted.load());
+    ControlServer::append_metric(out, "entorno_events_wakeups_total", posts.wakeups.load());
+    ControlServer::append_metric(out, "entorno_events_batches_total", posts.batches);
+    ControlServer::append_metric(out, "entorno_events_largest_batch", posts.largest_batch);
+    
+    if (icon_service) {
+        const auto& icons = icon_service->get_stats();
+        ControlServer::append_metric(out, "entorno_icon_cache_bytes", icons.bytes);
+        ControlServer::append_metric(out, "entorno_icon_cache_entries", icons.entries);
+        ControlServer::append_metric(out, "entorno_icon_cache_hits_total", icons.hits);
+        ControlServer::append_metric(out, "entorno_icon_cache_misses_total", icons.misses);
+    }
+    if (wallpaper_loader) {
+        ControlServer::append_metric(out, "entorno_wallpaper_texture_bytes", wallpaper_loader->get_texture_bytes());
+    }
+    if (timer_wheel) {
+        ControlServer::append_metric(out, "entorno_timer_wakeups_per_minute", timer_wheel->get_wakeups_per_minute());
+    }
+    if (system_monitor) {
+        ControlServer::append_metric(out, "entorno_load_applet_cpu_percent", system_monitor->get_self_cpu_percent());
+    }
+    ControlServer::append_metric(out, "entorno_rss_bytes", ProcessStats::rss_bytes());
+    
+    for (const auto& mark : timeline.get_marks()) {
+        ControlServer::append_metric(out, "entorno_startup_stage_us", mark.at_us, "stage=\"" + mark.stage + "\"");
+    }
+    return out;
+}
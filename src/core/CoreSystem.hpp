@@ -1,12 +1,22 @@
 // src/core/CoreSystem.hpp
 #pragma once
 #include "../wallpaper/WallpaperWindow.hpp"
+#include "../wallpaper/WallpaperLoader.hpp"
+#include "../wallpaper/WallpaperSlideshow.hpp"
 #include "../panel/TopPanel.hpp"
 #include <gtkmm/application.h>
 #include "../config/ThemeManager.hpp"
 #include "../app_launcher/AppLauncher.hpp"
 #include "../context_menu/DesktopContextMenu.hpp"
+#include "EventManager.hpp"
+#include "ControlServer.hpp"
+#include "IconService.hpp"
+#include "StartupTimeline.hpp"
+#include "TimerWheel.hpp"
+#include <deque>
+#include <functional>
 #include <memory> // Añadido para smart pointers
+#include <vector>
 
 class CoreSystem {
 public:
@@ -17,14 +27,60 @@ public:
     void stop();
     void reload_theme();
     void setup_context_menu();
+    void setup_control_server();
+    void set_wallpaper(const std::string& path);
+
+    const StartupTimeline& get_startup_timeline() const { return timeline; }
 
 private:
+    // Fondos ofrecidos en el menú contextual
+    static constexpr size_t RECENT_WALLPAPERS = 3;
+
+    // Ventanas propias de cada monitor
+    struct MonitorOutput {
+        Glib::RefPtr<Gdk::Monitor> monitor;
+        std::unique_ptr<WallpaperWindow> wallpaper;
+        std::unique_ptr<TopPanel> top_panel;
+    };
+
+    void sync_monitors();
+    void add_output(const Glib::RefPtr<Gdk::Monitor>& monitor);
+    void remove_output(size_t index);
+
+    // Arranque por etapas: lo visible primero, el resto en ranuras idle
+    void queue_deferred_stages();
+    bool run_next_stage();
+    static gboolean on_dump_signal(gpointer data);
+    static gboolean on_quit_signal(gpointer data);
+
+    // Mide cuánto tarda en pintarse el primer frame con el tema recargado
+    void watch_restyle();
+
     // Cambiamos a unique_ptr para gestión automática de memoria
-    std::unique_ptr<WallpaperWindow> wallpaper;
-    std::unique_ptr<TopPanel> top_panel;
+    std::unique_ptr<WallpaperLoader> wallpaper_loader;
+    std::unique_ptr<IconService> icon_service;     // Compartido por lanzador, menú y paneles
+    std::unique_ptr<AppSpawner> app_spawner;       // Lanzador y terminal del menú
+    std::unique_ptr<TimerWheel> timer_wheel;       // Trabajo periódico de los paneles
+    std::unique_ptr<SystemMonitor> system_monitor; // Muestras del applet de carga
+    std::vector<MonitorOutput> outputs;
+    sigc::connection monitors_connection;
+    EventManager::Subscription right_click_subscription;
+    std::unique_ptr<WallpaperSlideshow> slideshow;
     std::unique_ptr<AppLauncher> app_launcher;
     Glib::RefPtr<Gtk::Application> app;
     std::unique_ptr<ThemeManager> theme;
+    sigc::connection theme_reloaded_connection;
+    sigc::connection restyle_paint_connection;
     std::string theme_path;
     std::unique_ptr<DesktopContextMenu> context_menu;
+    std::unique_ptr<ControlServer> control_server;
+
+    std::string collect_metrics();
+
+    StartupTimeline timeline;
+    std::deque<std::function<void()>> startup_stages;
+    sigc::connection startup_idle;
+    guint dump_signal_source = 0;
+    guint trace_signal_source = 0;
+    guint quit_signal_sources[2] = {0, 0};     // SIGTERM, SIGINT
 };
\ No newline at end of file
@@ -1,17 +1,111 @@
 // EventManager.cpp
 #include "EventManager.hpp"
+#include <algorithm>
+#include <glib.h>
 
 EventManager& EventManager::get_instance() {
     static EventManager instance;
     return instance;
 }
 
-void EventManager::register_event(const std::string& name, Callback callback) {
-    events[name] = callback;
+EventId EventManager::intern(const std::string& name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    
+    EventId id = static_cast<EventId>(names.size());
+    ids.emplace(name, id);
+    names.push_back(name);
+    payload_types.push_back(nullptr);
+    subscribers.emplace_back();
+    dispatch_counts.push_back(0);
+    return id;
+}
+
+const std::string& EventManager::get_name(EventId id) const {
+    return names.at(id);
+}
+
+void EventManager::dispatch(EventId id, const void* payload) {
+    if (id >= subscribers.size()) {
+        return;
+    }
+    
+    // Por índice y con el tamaño fijado: un callback puede suscribir o dar
+    // de baja a otros sin invalidar el recorrido (las bajas se compactan al final)
+    dispatch_counts[id]++;
+    dispatch_depth++;
+    auto& list = subscribers[id];
+    size_t count = list.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (list[i].callback) {
+            list[i].callback(payload);
+        }
+    }
+    dispatch_depth--;
+    
+    if (dispatch_depth == 0 && needs_compaction) {
+        needs_compaction = false;
+        for (auto& event_subscribers : subscribers) {
+            event_subscribers.erase(std::remove_if(event_subscribers.begin(), event_subscribers.end(),
+                                                   [](const Subscriber& s) { return !s.callback; }),
+                                    event_subscribers.end());
+        }
+    }
+}
+
+void EventManager::unsubscribe(EventId id, uint64_t token) {
+    if (id >= subscribers.size()) {
+        return;
+    }
+    
+    auto& list = subscribers[id];
+    auto it = std::find_if(list.begin(), list.end(),
+                           [token](const Subscriber& s) { return s.token == token; });
+    if (it == list.end()) {
+        return;
+    }
+    
+    if (dispatch_depth > 0) {
+        it->callback = nullptr;
+        needs_compaction = true;
+    } else {
+        list.erase(it);
+    }
 }
 
-void EventManager::trigger_event(const std::string& name) {
-    if (events.find(name) != events.end()) {
-        events[name]();
+void EventManager::schedule_drain() {
+    // Ya hay un despertar programado: el evento irá en ese mismo lote
+    if (drain_scheduled.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    
+    // Como mucho un despertar por frame desde el último vaciado
+    int64_t since_last = g_get_monotonic_time() - last_drain_us.load(std::memory_order_relaxed);
+    guint delay_ms = 0;
+    if (since_last < FRAME_INTERVAL_US) {
+        delay_ms = static_cast<guint>((FRAME_INTERVAL_US - since_last + 999) / 1000);
     }
-}
\ No newline at end of file
+    
+    post_stats.wakeups.fetch_add(1, std::memory_order_relaxed);
+    // g_timeout_add_full es seguro desde cualquier hilo
+    g_timeout_add_full(G_PRIORITY_DEFAULT, delay_ms, &EventManager::on_drain, this, nullptr);
+}
+
+int EventManager::on_drain(void* data) {
+    auto* self = static_cast<EventManager*>(data);
+    self->last_drain_us.store(g_get_monotonic_time(), std::memory_order_relaxed);
+    // Antes de vaciar: lo que llegue a partir de aquí programa otro despertar
+    self->drain_scheduled.store(false, std::memory_order_release);
+    
+    size_t count = self->posted_events.drain([](std::function<void()>&& deliver) {
+        deliver();
+    });
+    
+    if (count > 0) {
+        self->post_stats.batches++;
+        self->post_stats.largest_batch = std::max<uint64_t>(self->post_stats.largest_batch, count);
+    }
+    return G_SOURCE_REMOVE;
+}
@@ -1,19 +1,206 @@
 // EventManager.hpp
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
 #include <functional>
-#include <map>
+#include <iostream>
 #include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+#include "../utils/MpscQueue.hpp"
 
+// Identificador interno de un evento: índice directo en la tabla de suscriptores
+using EventId = uint32_t;
+
+// Clave tipada de un evento: fija el tipo de datos que lleva
+template<typename Payload>
+struct Event {
+    EventId id;
+};
+
+// Bus de eventos del escritorio. Los nombres se convierten una sola vez en
+// EventId (intern), y cada disparo es un acceso directo por índice, sin
+// búsquedas por cadena. Un evento admite varios suscriptores; cada uno recibe
+// una Subscription que lo da de baja al destruirse.
+//
+// Todo se usa desde el hilo principal salvo post(), que los hilos de trabajo
+// usan para entregar resultados: encola sin bloqueos y el bucle principal
+// vacía la cola como un solo lote, despertando como mucho una vez por frame.
 class EventManager {
 public:
-    using Callback = std::function<void()>;
-    
+    // Baja automática (RAII) de un suscriptor
+    class Subscription {
+    public:
+        Subscription() = default;
+        ~Subscription() { reset(); }
+
+        Subscription(Subscription&& other) noexcept { *this = std::move(other); }
+        Subscription& operator=(Subscription&& other) noexcept {
+            if (this != &other) {
+                reset();
+                manager = other.manager;
+                id = other.id;
+                token = other.token;
+                other.manager = nullptr;
+            }
+            return *this;
+        }
+
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+
+        void reset() {
+            if (manager) {
+                manager->unsubscribe(id, token);
+                manager = nullptr;
+            }
+        }
+
+    private:
+        friend class EventManager;
+        Subscription(EventManager* manager, EventId id, uint64_t token)
+            : manager(manager), id(id), token(token) {}
+
+        EventManager* manager = nullptr;
+        EventId id = 0;
+        uint64_t token = 0;
+    };
+
     static EventManager& get_instance();
-    
-    void register_event(const std::string& name, Callback callback);
-    void trigger_event(const std::string& name);
-    
+
+    // Mismo nombre -> mismo EventId
+    EventId intern(const std::string& name);
+    const std::string& get_name(EventId id) const;
+
+    template<typename Payload>
+    Event<Payload> event(const std::string& name) {
+        EventId id = intern(name);
+        auto& type = payload_types[id];
+        if (!type) {
+            type = &typeid(Payload);
+        } else if (*type != typeid(Payload)) {
+            // Los suscriptores recibirían datos de otro tipo: error de programación
+            std::cerr << "Evento '" << name << "' declarado con otro tipo de datos" << std::endl;
+            std::abort();
+        }
+        return Event<Payload>{id};
+    }
+
+    // callback: cualquier invocable con firma void(const Payload&)
+    template<typename Payload, typename Callback>
+    [[nodiscard]] Subscription subscribe(Event<Payload> event, Callback callback) {
+        uint64_t token = next_token++;
+        subscribers[event.id].push_back({token, [callback = std::move(callback)](const void* payload) {
+            callback(*static_cast<const Payload*>(payload));
+        }});
+        return Subscription(this, event.id, token);
+    }
+
+    template<typename Payload>
+    void emit(Event<Payload> event, const Payload& payload) {
+        dispatch(event.id, &payload);
+    }
+
+    // Seguro desde cualquier hilo: el evento se emite en el hilo principal en
+    // el siguiente lote. La clave (event) se obtiene antes en el hilo principal.
+    template<typename Payload>
+    void post(Event<Payload> event, Payload payload) {
+        posted_events.push([this, event, payload = std::move(payload)]() {
+            emit(event, payload);
+        });
+        post_stats.posted.fetch_add(1, std::memory_order_relaxed);
+        schedule_drain();
+    }
+
+    struct PostStats {
+        std::atomic<uint64_t> posted{0};        // Eventos encolados desde otros hilos
+        std::atomic<uint64_t> wakeups{0};       // Despertares del bucle principal
+        uint64_t batches = 0;                   // Lotes vaciados (hilo principal)
+        uint64_t largest_batch = 0;
+    };
+    const PostStats& get_post_stats() const { return post_stats; }
+
+    // Identificador de dueño para WorkerResults: creciente y nunca reutilizado
+    uint64_t new_owner_id() { return next_owner_id++; }
+
+    // Veces que se disparó cada evento (índice: EventId)
+    size_t get_event_count() const { return names.size(); }
+    uint64_t get_dispatch_count(EventId id) const { return dispatch_counts.at(id); }
+
 private:
+    struct Subscriber {
+        uint64_t token;
+        std::function<void(const void*)> callback;   // Vacío = dado de baja durante un disparo
+    };
+
     EventManager() = default;
-    std::map<std::string, Callback> events;
-};
\ No newline at end of file
+
+    void dispatch(EventId id, const void* payload);
+    void unsubscribe(EventId id, uint64_t token);
+    void schedule_drain();
+    static int on_drain(void* data);
+
+    // Un frame a 60 Hz: intervalo mínimo entre dos despertares por post()
+    static constexpr int64_t FRAME_INTERVAL_US = 16667;
+
+    std::unordered_map<std::string, EventId> ids;
+    std::vector<std::string> names;
+    std::vector<const std::type_info*> payload_types;
+    // deque (ambas): ni un evento nuevo (intern) ni un suscriptor nuevo
+    // durante un disparo mueven las listas o suscriptores existentes
+    std::deque<std::deque<Subscriber>> subscribers;
+    std::vector<uint64_t> dispatch_counts;
+    uint64_t next_token = 1;
+    uint64_t next_owner_id = 1;
+    int dispatch_depth = 0;
+    bool needs_compaction = false;
+
+    MpscQueue<std::function<void()>> posted_events;
+    std::atomic<bool> drain_scheduled{false};
+    std::atomic<int64_t> last_drain_us{0};
+    PostStats post_stats;
+};
+
+// Resultados de los hilos de trabajo de un objeto, entregados en el hilo
+// principal solo a ese objeto. Todas las instancias de una clase comparten el
+// evento; cada una filtra por su propio identificador, que a diferencia de su
+// dirección no se reutiliza: un resultado que llega después de destruir a su
+// dueño no se entrega a otro objeto creado en el mismo sitio.
+template<typename Payload>
+class WorkerResults {
+public:
+    // Hilo principal, antes de lanzar los hilos que llaman a post()
+    template<typename Callback>
+    void open(const std::string& name, Callback callback) {
+        auto& events = EventManager::get_instance();
+        event_ = events.event<Tagged>(name);
+        owner_ = events.new_owner_id();
+        subscription_ = events.subscribe(event_,
+            [owner = owner_, callback = std::move(callback)](const Tagged& tagged) {
+                if (tagged.owner == owner) {
+                    callback(tagged.payload);
+                }
+            });
+    }
+
+    // Hilo principal: deja de entregar resultados
+    void close() { subscription_.reset(); }
+
+    // Desde cualquier hilo
+    void post(Payload payload) {
+        EventManager::get_instance().post(event_, Tagged{owner_, std::move(payload)});
+    }
+
+private:
+    struct Tagged {
+        uint64_t owner;
+        Payload payload;
+    };
+
+    Event<Tagged> event_{0};
+    uint64_t owner_ = 0;
+    EventManager::Subscription subscription_;
+};
@@ -0,0 +1,22 @@
+// Events.hpp
+#pragma once
+#include "EventManager.hpp"
+
+namespace Gtk { class Widget; }
+
+// Eventos del escritorio y los datos que llevan
+
+struct PointerEvent {
+    double x;                   // Coordenadas relativas a widget
+    double y;
+    Gtk::Widget* widget;        // Widget que recibió el clic
+};
+
+namespace Events {
+
+    inline Event<PointerEvent> desktop_right_click() {
+        static const auto event = EventManager::get_instance().event<PointerEvent>("desktop_right_click");
+        return event;
+    }
+
+} // namespace Events
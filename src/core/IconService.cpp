@@ -0,0 +1,233 @@
+// IconService.cpp
+#include "IconService.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// Marca en cada Gtk::Image el icono que debe mostrar
+constexpr const char* IMAGE_ICON_KEY = "entorno-icon-key";
+
+std::string make_key(const std::string& name, int pixels) {
+    return name + "@" + std::to_string(pixels);
+}
+
+bool is_symbolic(const std::string& name) {
+    static const std::string suffix = "-symbolic";
+    return name.size() > suffix.size() &&
+           name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+IconService::IconService(size_t max_bytes, unsigned int threads)
+    : max_bytes_(max_bytes) {
+    auto display = Gdk::Display::get_default();
+    if (display) {
+        icon_theme_ = Gtk::IconTheme::get_for_display(display);
+    }
+    
+    result_ready_.open("icon_ready", [this](const Result& result) { on_result(result); });
+    
+    for (unsigned int i = 0; i < std::max(1u, threads); ++i) {
+        workers_.emplace_back(&IconService::worker_loop, this);
+    }
+}
+
+IconService::~IconService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        jobs_.clear();
+    }
+    jobs_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    result_ready_.close();
+}
+
+void IconService::request(const std::string& name, int size, int scale, Callback callback) {
+    std::string key = make_key(name, size * scale);
+    
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+        stats_.hits++;
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+        callback(it->second.texture);
+        return;
+    }
+    stats_.misses++;
+    
+    // Ya se está cargando: esperar al mismo resultado
+    auto& waiting = pending_[key];
+    waiting.push_back(std::move(callback));
+    if (waiting.size() > 1) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back({key, name, size, scale});
+    }
+    jobs_cv_.notify_one();
+}
+
+void IconService::load_into(Gtk::Image& image, const std::string& name, int size) {
+    image.set_pixel_size(size);
+    
+    if (is_symbolic(name)) {
+        g_object_set_data(G_OBJECT(image.gobj()), IMAGE_ICON_KEY, nullptr);
+        image.set_from_icon_name(name);
+        return;
+    }
+    
+    int scale = std::max(1, image.get_scale_factor());
+    std::string key = make_key(name, size * scale);
+    g_object_set_data_full(G_OBJECT(image.gobj()), IMAGE_ICON_KEY, g_strdup(key.c_str()), g_free);
+    
+    // Marcador primero: si el icono está en caché se sustituye en el acto
+    Glib::RefPtr<Gdk::Texture> empty = placeholder(size * scale);
+    image.set(empty);
+    if (name.empty()) {
+        return;
+    }
+    
+    // track_obj: si image se destruye, el callback no se llama
+    request(name, size, scale, sigc::track_obj([&image, key](const Glib::RefPtr<Gdk::Texture>& texture) {
+        const char* wanted = static_cast<const char*>(g_object_get_data(G_OBJECT(image.gobj()), IMAGE_ICON_KEY));
+        if (texture && wanted && key == wanted) {
+            image.set(texture);
+        }
+    }, image));
+}
+
+const IconService::Stats& IconService::get_stats() const {
+    return stats_;
+}
+
+void IconService::worker_loop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobs_cv_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            // Lo último pedido primero: suele ser lo que está en pantalla
+            job = std::move(jobs_.back());
+            jobs_.pop_back();
+        }
+        
+        result_ready_.post(Result{job.key, load_icon(job)});
+    }
+}
+
+Glib::RefPtr<Gdk::Pixbuf> IconService::load_icon(const Job& job) const {
+    int pixels = job.size * job.scale;
+    GError* error = nullptr;
+    GdkPixbuf* pixbuf = nullptr;
+    
+    if (job.name.empty()) {
+        return Glib::RefPtr<Gdk::Pixbuf>();
+    }
+    if (job.name.front() == '/') {
+        // Icon= con ruta absoluta: se decodifica tal cual
+        pixbuf = gdk_pixbuf_new_from_file_at_scale(job.name.c_str(), pixels, pixels, TRUE, &error);
+    } else if (icon_theme_) {
+        // GtkIconTheme es seguro entre hilos en GTK 4; la búsqueda no decodifica
+        const char* fallbacks[] = {"application-x-executable", nullptr};
+        GtkIconPaintable* paintable = gtk_icon_theme_lookup_icon(icon_theme_->gobj(), job.name.c_str(), fallbacks,
+                                                                 job.size, job.scale, GTK_TEXT_DIR_NONE,
+                                                                 static_cast<GtkIconLookupFlags>(0));
+        GFile* file = paintable ? gtk_icon_paintable_get_file(paintable) : nullptr;
+        if (file) {
+            if (char* path = g_file_get_path(file)) {
+                pixbuf = gdk_pixbuf_new_from_file_at_scale(path, pixels, pixels, TRUE, &error);
+                g_free(path);
+            } else if (g_file_has_uri_scheme(file, "resource")) {
+                // Iconos integrados en GTK (p. ej. image-missing)
+                char* uri = g_file_get_uri(file);
+                pixbuf = gdk_pixbuf_new_from_resource_at_scale(uri + std::strlen("resource://"),
+                                                               pixels, pixels, TRUE, &error);
+                g_free(uri);
+            }
+            g_object_unref(file);
+        }
+        if (paintable) {
+            g_object_unref(paintable);
+        }
+    }
+    
+    if (error) {
+        std::cerr << "Error cargando icono " << job.name << ": " << error->message << std::endl;
+        g_error_free(error);
+    }
+    return pixbuf ? Glib::wrap(pixbuf) : Glib::RefPtr<Gdk::Pixbuf>();
+}
+
+void IconService::on_result(const Result& result) {
+    Glib::RefPtr<Gdk::Texture> texture;
+    if (result.pixbuf) {
+        texture = Gdk::Texture::create_for_pixbuf(result.pixbuf);
+        stats_.decoded++;
+    } else {
+        stats_.failed++;
+    }
+    insert(result.key, texture);
+    
+    auto it = pending_.find(result.key);
+    if (it == pending_.end()) {
+        return;
+    }
+    auto callbacks = std::move(it->second);
+    pending_.erase(it);
+    for (auto& callback : callbacks) {
+        callback(texture);
+    }
+}
+
+void IconService::insert(const std::string& key, const Glib::RefPtr<Gdk::Texture>& texture) {
+    size_t bytes = key.size();
+    if (texture) {
+        bytes += static_cast<size_t>(texture->get_width()) * texture->get_height() * 4;
+    }
+    
+    auto existing = cache_.find(key);
+    if (existing != cache_.end()) {
+        stats_.bytes -= existing->second.bytes;
+        lru_.erase(existing->second.lru);
+        cache_.erase(existing);
+    }
+    
+    lru_.push_front(key);
+    cache_[key] = {texture, bytes, lru_.begin()};
+    stats_.bytes += bytes;
+    
+    // Expulsar los menos usados; las ventanas que los muestran conservan su referencia
+    while (stats_.bytes > max_bytes_ && lru_.size() > 1) {
+        auto victim = cache_.find(lru_.back());
+        stats_.bytes -= victim->second.bytes;
+        cache_.erase(victim);
+        lru_.pop_back();
+        stats_.evictions++;
+    }
+    stats_.entries = cache_.size();
+}
+
+Glib::RefPtr<Gdk::Texture> IconService::placeholder(int pixels) {
+    auto& texture = placeholders_[pixels];
+    if (!texture) {
+        // Cuadrado gris translúcido, compartido por todas las imágenes de ese tamaño
+        std::vector<guint8> data(static_cast<size_t>(pixels) * pixels * 4);
+        for (size_t i = 0; i < data.size(); i += 4) {
+            data[i] = data[i + 1] = data[i + 2] = 128;
+            data[i + 3] = 48;
+        }
+        auto bytes = Glib::Bytes::create(data.data(), data.size());
+        texture = Gdk::MemoryTexture::create(pixels, pixels, Gdk::MemoryFormat::R8G8B8A8, bytes, pixels * 4);
+    }
+    return texture;
+}
@@ -0,0 +1,94 @@
+// IconService.hpp
+#pragma once
+#include <gtkmm.h>
+#include "EventManager.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Iconos compartidos por el lanzador, el menú contextual y el panel. El
+// nombre se resuelve en el tema de iconos y la imagen (PNG, SVG...) se
+// decodifica al tamaño exacto en hilos de trabajo. Las texturas quedan en
+// una caché LRU con límite de memoria; mientras llegan se muestra un marcador.
+class IconService {
+public:
+    using Callback = sigc::slot<void(const Glib::RefPtr<Gdk::Texture>&)>;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t decoded = 0;
+        uint64_t failed = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;           // Memoria de las texturas en caché
+    };
+
+    explicit IconService(size_t max_bytes = 16 * 1024 * 1024, unsigned int threads = 2);
+    ~IconService();
+
+    // size en píxeles lógicos. Si el icono está en caché el callback se llama
+    // enseguida; si no se encuentra recibe una textura nula.
+    void request(const std::string& name, int size, int scale, Callback callback);
+
+    // Pone un marcador en image y lo sustituye por el icono cuando esté
+    // listo. Si la imagen se destruye o pasa a mostrar otro icono antes, el
+    // resultado se descarta. Los iconos simbólicos los carga GTK, que los
+    // recolorea con el color del tema.
+    void load_into(Gtk::Image& image, const std::string& name, int size);
+
+    const Stats& get_stats() const;
+
+    IconService(const IconService&) = delete;
+    IconService& operator=(const IconService&) = delete;
+
+private:
+    struct Job {
+        std::string key;
+        std::string name;
+        int size;
+        int scale;
+    };
+
+    // Llega al hilo principal por result_ready_
+    struct Result {
+        std::string key;
+        Glib::RefPtr<Gdk::Pixbuf> pixbuf;   // Nulo si no se pudo cargar
+    };
+
+    struct CacheEntry {
+        Glib::RefPtr<Gdk::Texture> texture; // Nula: icono inexistente (también se recuerda)
+        size_t bytes;
+        std::list<std::string>::iterator lru;
+    };
+
+    void worker_loop();
+    Glib::RefPtr<Gdk::Pixbuf> load_icon(const Job& job) const;
+    void on_result(const Result& result);
+    void insert(const std::string& key, const Glib::RefPtr<Gdk::Texture>& texture);
+    Glib::RefPtr<Gdk::Texture> placeholder(int pixels);
+
+    Glib::RefPtr<Gtk::IconTheme> icon_theme_;
+
+    // Hilo principal: caché, peticiones en curso y marcadores por tamaño
+    size_t max_bytes_;
+    std::unordered_map<std::string, CacheEntry> cache_;
+    std::list<std::string> lru_;        // El más reciente al principio
+    std::unordered_map<std::string, std::vector<Callback>> pending_;
+    std::unordered_map<int, Glib::RefPtr<Gdk::Texture>> placeholders_;
+    Stats stats_;
+
+    // Hilos de trabajo
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable jobs_cv_;
+    std::deque<Job> jobs_;
+    bool stopping_ = false;
+    WorkerResults<Result> result_ready_;
+};
@@ -0,0 +1,37 @@
+// StartupTimeline.cpp
+#include "StartupTimeline.hpp"
+#include <glib.h>
+#include <iomanip>
+
+StartupTimeline::StartupTimeline() : origin_us_(g_get_monotonic_time()) {
+    marks_.reserve(16);
+}
+
+void StartupTimeline::mark(const std::string& stage) {
+    marks_.push_back({stage, g_get_monotonic_time() - origin_us_});
+}
+
+int64_t StartupTimeline::elapsed_us(const std::string& stage) const {
+    for (const auto& mark : marks_) {
+        if (mark.stage == stage) {
+            return mark.at_us;
+        }
+    }
+    return -1;
+}
+
+void StartupTimeline::dump(std::ostream& out) const {
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << "Arranque (ms desde el inicio | ms de la etapa):" << std::endl;
+    int64_t previous = 0;
+    for (const auto& mark : marks_) {
+        out << std::fixed << std::setprecision(2)
+            << std::setw(10) << mark.at_us / 1000.0 << " | "
+            << std::setw(8) << (mark.at_us - previous) / 1000.0 << "  "
+            << mark.stage << std::endl;
+        previous = mark.at_us;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
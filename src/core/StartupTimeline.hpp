@@ -0,0 +1,30 @@
+// StartupTimeline.hpp
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Marcas de tiempo de cada etapa del arranque, relativas a la creación de
+// CoreSystem. Se vuelcan al terminar el arranque y con SIGUSR1.
+class StartupTimeline {
+public:
+    struct Mark {
+        std::string stage;
+        int64_t at_us;      // Desde el origen
+    };
+
+    StartupTimeline();
+
+    void mark(const std::string& stage);
+    
+    // Microsegundos hasta la etapa, o -1 si todavía no ocurrió
+    int64_t elapsed_us(const std::string& stage) const;
+    
+    const std::vector<Mark>& get_marks() const { return marks_; }
+    void dump(std::ostream& out) const;
+
+private:
+    int64_t origin_us_;
+    std::vector<Mark> marks_;
+};
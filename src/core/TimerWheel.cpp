@@ -0,0 +1,132 @@
+// TimerWheel.cpp
+#include "TimerWheel.hpp"
+#include <algorithm>
+
+TimerWheel::~TimerWheel() {
+    timer_.disconnect();
+}
+
+int64_t TimerWheel::next_boundary(int64_t period_us, int64_t now_us) {
+    return (now_us / period_us + 1) * period_us;
+}
+
+TimerWheel::Entry* TimerWheel::find(Id id) {
+    auto it = std::find_if(entries_.begin(), entries_.end(), [id](const Entry& entry) { return entry.id == id; });
+    return it == entries_.end() ? nullptr : &*it;
+}
+
+void TimerWheel::realign(int64_t now_us) {
+    // La hora real puede retroceder (NTP, cambio manual): un vencimiento a
+    // más de un periodo en el futuro se recalcula, o la entrada no volvería
+    // a dispararse hasta alcanzar la hora antigua
+    for (auto& entry : entries_) {
+        if (entry.next_due_us - now_us > entry.period_us) {
+            entry.next_due_us = next_boundary(entry.period_us, now_us);
+        }
+    }
+}
+
+TimerWheel::Id TimerWheel::add(unsigned int period_seconds, std::function<void()> callback, bool active) {
+    int64_t period_us = static_cast<int64_t>(std::max(1u, period_seconds)) * G_USEC_PER_SEC;
+    Id id = next_id_++;
+    entries_.push_back({id, period_us, std::move(callback), active,
+                        next_boundary(period_us, g_get_real_time())});
+    reschedule();
+    return id;
+}
+
+void TimerWheel::remove(Id id) {
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                  [id](const Entry& entry) { return entry.id == id; }),
+                   entries_.end());
+    reschedule();
+}
+
+void TimerWheel::set_active(Id id, bool active) {
+    Entry* entry = find(id);
+    if (!entry || entry->active == active) {
+        return;
+    }
+    entry->active = active;
+    int64_t now = g_get_real_time();
+    if (active) {
+        entry->next_due_us = next_boundary(entry->period_us, now);
+    }
+    realign(now);
+    reschedule();
+}
+
+const TimerWheel::Stats& TimerWheel::get_stats() const {
+    return stats_;
+}
+
+size_t TimerWheel::get_wakeups_per_minute() {
+    int64_t since = g_get_monotonic_time() - 60 * G_USEC_PER_SEC;
+    while (!recent_wakeups_.empty() && recent_wakeups_.front() < since) {
+        recent_wakeups_.pop_front();
+    }
+    return recent_wakeups_.size();
+}
+
+void TimerWheel::reschedule() {
+    int64_t due = INT64_MAX;
+    size_t active = 0;
+    for (const auto& entry : entries_) {
+        if (entry.active) {
+            due = std::min(due, entry.next_due_us);
+            ++active;
+        }
+    }
+    stats_.active = active;
+    
+    // Dentro de on_tick se reprograma una sola vez, al final
+    if (in_tick_) {
+        return;
+    }
+    if (active == 0) {
+        timer_.disconnect();
+        return;
+    }
+    if (timer_.connected() && scheduled_for_us_ == due) {
+        return;
+    }
+    
+    // Un milisegundo de más: GLib redondea a ms y no debe despertar antes de tiempo
+    timer_.disconnect();
+    scheduled_for_us_ = due;
+    int64_t delay_ms = std::max<int64_t>(0, (due - g_get_real_time()) / 1000 + 1);
+    timer_ = Glib::signal_timeout().connect(sigc::mem_fun(*this, &TimerWheel::on_tick),
+                                            static_cast<unsigned int>(delay_ms));
+}
+
+bool TimerWheel::on_tick() {
+    int64_t now = g_get_real_time();
+    ++stats_.wakeups;
+    recent_wakeups_.push_back(g_get_monotonic_time());
+    get_wakeups_per_minute();
+    
+    in_tick_ = true;
+    realign(now);
+    
+    // Primero se reúnen las entradas vencidas: un callback puede añadir o quitar otras
+    std::vector<Id> due;
+    for (auto& entry : entries_) {
+        if (entry.active && entry.next_due_us <= now + SLACK_US) {
+            due.push_back(entry.id);
+            entry.next_due_us = next_boundary(entry.period_us, now + SLACK_US);
+        }
+    }
+    for (Id id : due) {
+        if (Entry* entry = find(id)) {
+            ++stats_.callbacks;
+            auto callback = entry->callback;
+            callback();
+        }
+    }
+    
+    // Temporizador de un solo disparo: este termina al devolver false
+    in_tick_ = false;
+    timer_ = sigc::connection();
+    reschedule();
+    return false;
+}
@@ -0,0 +1,64 @@
+// TimerWheel.hpp
+#pragma once
+#include <glibmm.h>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+// Planificador común para el trabajo periódico de los paneles (reloj,
+// applets). Los periodos se alinean a la hora real (justo al cambiar de
+// segundo, de minuto...) y todo lo que vence en el mismo instante se
+// ejecuta en un único despertar. Sin entradas activas no hay temporizador.
+class TimerWheel {
+public:
+    using Id = uint32_t;
+
+    struct Stats {
+        uint64_t wakeups = 0;       // Veces que el temporizador despertó
+        uint64_t callbacks = 0;     // Callbacks ejecutados en total
+        size_t active = 0;          // Entradas activas ahora
+    };
+
+    TimerWheel() = default;
+    ~TimerWheel();
+
+    // callback se ejecuta en cada múltiplo de period_seconds de la hora real
+    Id add(unsigned int period_seconds, std::function<void()> callback, bool active = true);
+    void remove(Id id);
+    // Las entradas inactivas (p. ej. de un panel oculto) no despiertan al proceso
+    void set_active(Id id, bool active);
+
+    const Stats& get_stats() const;
+    // Despertares en los últimos 60 s
+    size_t get_wakeups_per_minute();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+private:
+    struct Entry {
+        Id id;
+        int64_t period_us;
+        std::function<void()> callback;
+        bool active;
+        int64_t next_due_us;    // Hora real (g_get_real_time)
+    };
+
+    // Margen para agrupar entradas que vencen casi a la vez
+    static constexpr int64_t SLACK_US = 2000;
+
+    static int64_t next_boundary(int64_t period_us, int64_t now_us);
+    Entry* find(Id id);
+    void realign(int64_t now_us);
+    void reschedule();
+    bool on_tick();
+
+    std::vector<Entry> entries_;
+    Id next_id_ = 1;
+    sigc::connection timer_;
+    int64_t scheduled_for_us_ = 0;
+    bool in_tick_ = false;
+    Stats stats_;
+    std::deque<int64_t> recent_wakeups_;    // Monotónico, para la tasa por minuto
+};
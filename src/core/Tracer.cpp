@@ -0,0 +1,155 @@
+// Tracer.cpp
+#include "Tracer.hpp"
+#include <glib.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+
+const char* trace_setting() {
+    const char* value = std::getenv("ENTORNO_TRACE");
+    return (value && *value && std::strcmp(value, "0") != 0) ? value : nullptr;
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::enabled_{trace_setting() != nullptr};
+thread_local Tracer::BufferLease Tracer::lease_;
+
+Tracer& Tracer::get_instance() {
+    static Tracer instance;
+    return instance;
+}
+
+Tracer::Tracer() {
+    const char* setting = trace_setting();
+    if (setting && std::strcmp(setting, "1") != 0) {
+        output_path_ = setting;
+    } else {
+        output_path_ = "/tmp/entorno-trace-" + std::to_string(getpid()) + ".json";
+    }
+}
+
+Tracer::BufferLease::~BufferLease() {
+    if (buffer) {
+        auto& tracer = Tracer::get_instance();
+        std::lock_guard<std::mutex> lock(tracer.mutex_);
+        tracer.free_buffers_.push_back(buffer);
+    }
+}
+
+Tracer::ThreadBuffer* Tracer::acquire_buffer() {
+    // Los hilos de vida corta (p. ej. la construcción del tema) reutilizan anillos
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_buffers_.empty()) {
+        ThreadBuffer* buffer = free_buffers_.back();
+        free_buffers_.pop_back();
+        return buffer;
+    }
+    buffers_.push_back(std::make_unique<ThreadBuffer>());
+    return buffers_.back().get();
+}
+
+void Tracer::record(const char* name, int64_t start_us, int64_t duration_us) {
+    if (!lease_.buffer) {
+        lease_.buffer = acquire_buffer();
+        lease_.tid = gettid();
+    }
+    ThreadBuffer& buffer = *lease_.buffer;
+    uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    Slot& slot = buffer.slots[index % SPANS_PER_THREAD];
+    
+    // Un solo escritor por anillo: basta con marcar la posición como ocupada
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start_us.store(start_us, std::memory_order_relaxed);
+    slot.duration_us.store(duration_us, std::memory_order_relaxed);
+    slot.tid.store(lease_.tid, std::memory_order_relaxed);
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::set_thread_name(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    thread_names_[gettid()] = name;
+}
+
+bool Tracer::read_slot(const Slot& slot, Span& span) {
+    uint64_t before = slot.sequence.load(std::memory_order_acquire);
+    if (before & 1) {
+        return false;
+    }
+    span.name = slot.name.load(std::memory_order_relaxed);
+    span.start_us = slot.start_us.load(std::memory_order_relaxed);
+    span.duration_us = slot.duration_us.load(std::memory_order_relaxed);
+    span.tid = slot.tid.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return span.name && slot.sequence.load(std::memory_order_relaxed) == before;
+}
+
+bool Tracer::dump() {
+    return dump(output_path_);
+}
+
+bool Tracer::dump(const std::string& path) {
+    // Los hilos siguen escribiendo: cada posición se lee con su seqlock y
+    // se omite si estaba a medio escribir
+    std::vector<Span> spans;
+    std::map<pid_t, std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        names = thread_names_;
+        for (const auto& buffer : buffers_) {
+            uint64_t written = buffer->written.load(std::memory_order_acquire);
+            uint64_t first = written > SPANS_PER_THREAD ? written - SPANS_PER_THREAD : 0;
+            for (uint64_t i = first; i < written; ++i) {
+                Span span;
+                if (read_slot(buffer->slots[i % SPANS_PER_THREAD], span)) {
+                    spans.push_back(span);
+                }
+            }
+        }
+    }
+    std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) { return a.start_us < b.start_us; });
+    
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    int pid = getpid();
+    std::fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (const auto& [tid, name] : names) {
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                     first ? "" : ",\n", pid, static_cast<int>(tid), name.c_str());
+        first = false;
+    }
+    for (const auto& span : spans) {
+        std::fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":%d,\"tid\":%d}",
+                     first ? "" : ",\n", span.name, static_cast<long long>(span.start_us),
+                     static_cast<long long>(span.duration_us), pid, static_cast<int>(span.tid));
+        first = false;
+    }
+    std::fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    bool ok = std::fclose(file) == 0;
+    
+    std::fprintf(stdout, "Trazas: %zu tramos en %s\n", spans.size(), path.c_str());
+    return ok;
+}
+
+TraceSpan::TraceSpan(const char* name) : name_(Tracer::enabled() ? name : nullptr) {
+    if (name_) {
+        start_us_ = g_get_monotonic_time();
+    }
+}
+
+TraceSpan::~TraceSpan() {
+    if (name_) {
+        Tracer::get_instance().record(name_, start_us_, g_get_monotonic_time() - start_us_);
+    }
+}
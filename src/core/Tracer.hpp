@@ -0,0 +1,94 @@
+// Tracer.hpp
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+// Trazas de tramos (spans) para ver dónde se va el tiempo. Se activa con la
+// variable de entorno ENTORNO_TRACE (ruta del archivo de salida, o "1" para
+// /tmp/entorno-trace-<pid>.json). Cada hilo escribe en su propio anillo sin
+// bloqueos; el volcado genera JSON de Chrome trace-event (chrome://tracing,
+// Perfetto). Desactivado, un tramo cuesta una lectura atómica.
+class Tracer {
+public:
+    static Tracer& get_instance();
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // name debe ser un literal: solo se guarda el puntero
+    void record(const char* name, int64_t start_us, int64_t duration_us);
+    void set_thread_name(const std::string& name);
+
+    // Escribe los tramos guardados; false si no se pudo escribir
+    bool dump(const std::string& path);
+    bool dump();
+    const std::string& get_output_path() const { return output_path_; }
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+private:
+    static constexpr size_t SPANS_PER_THREAD = 8192;
+
+    struct Span {
+        const char* name;
+        int64_t start_us;
+        int64_t duration_us;
+        pid_t tid;
+    };
+
+    // Posición del anillo con su propio seqlock: dump() lee mientras el
+    // hilo dueño escribe, y descarta las posiciones que cambian a medias
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};     // Impar mientras se escribe
+        std::atomic<const char*> name{nullptr};
+        std::atomic<int64_t> start_us{0};
+        std::atomic<int64_t> duration_us{0};
+        std::atomic<pid_t> tid{0};
+    };
+
+    // Anillo de un hilo; al terminar el hilo se recicla para otro
+    struct ThreadBuffer {
+        std::array<Slot, SPANS_PER_THREAD> slots;
+        std::atomic<uint64_t> written{0};
+    };
+
+    // Devuelve el anillo al terminar el hilo
+    struct BufferLease {
+        ThreadBuffer* buffer = nullptr;
+        pid_t tid = 0;
+        ~BufferLease();
+    };
+
+    Tracer();
+    ThreadBuffer* acquire_buffer();
+    static bool read_slot(const Slot& slot, Span& span);
+
+    static std::atomic<bool> enabled_;
+    static thread_local BufferLease lease_;
+
+    std::string output_path_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    std::vector<ThreadBuffer*> free_buffers_;
+    std::map<pid_t, std::string> thread_names_;
+};
+
+// Mide desde su construcción hasta el final del ámbito
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;      // Nulo con las trazas desactivadas
+    int64_t start_us_ = 0;
+};
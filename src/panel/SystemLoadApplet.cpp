@@ -0,0 +1,112 @@
+// SystemLoadApplet.cpp
+#include "SystemLoadApplet.hpp"
+#include "../utils/ProcessStats.hpp"
+#include <algorithm>
+#include <cstdio>
+
+SystemLoadApplet::SystemLoadApplet(SystemMonitor& system_monitor)
+    : system_monitor(system_monitor) {
+    add_css_class("system-load");
+    set_content_width(GRAPH_WIDTH * 3 + GRAPH_GAP * 2);
+    set_content_height(HEIGHT);
+    set_valign(Gtk::Align::CENTER);
+    set_draw_func(sigc::mem_fun(*this, &SystemLoadApplet::on_draw));
+    
+    sampled_connection = system_monitor.signal_sampled().connect(
+        sigc::mem_fun(*this, &SystemLoadApplet::on_sampled));
+    signal_map().connect([this]() { set_sampling(true); });
+    signal_unmap().connect([this]() { set_sampling(false); });
+}
+
+SystemLoadApplet::~SystemLoadApplet() {
+    sampled_connection.disconnect();
+    after_paint_connection.disconnect();
+    set_sampling(false);
+}
+
+void SystemLoadApplet::set_sampling(bool active) {
+    if (active == sampling) {
+        return;
+    }
+    sampling = active;
+    if (active) {
+        system_monitor.acquire();
+    } else {
+        system_monitor.release();
+    }
+}
+
+void SystemLoadApplet::on_sampled() {
+    if (!sampling) {
+        return;
+    }
+    queue_draw();
+    
+    // Coste del frame que provoca la muestra: CPU del hilo principal hasta
+    // que GTK termina de pintar (estilo, layout, dibujo y render). Cota
+    // superior: incluye lo demás que se pinte en el mismo frame
+    auto clock = get_frame_clock();
+    if (clock && !after_paint_connection.connected()) {
+        frame_cpu_start_ns = ProcessStats::thread_cpu_ns();
+        after_paint_connection = clock->signal_after_paint().connect([this]() {
+            after_paint_connection.disconnect();
+            system_monitor.add_frame_cpu(ProcessStats::thread_cpu_ns() - frame_cpu_start_ns);
+        });
+    }
+    
+    const auto& history = system_monitor.get_history();
+    if (history.empty()) {
+        return;
+    }
+    const auto& last = history.back();
+    char text[96];
+    std::snprintf(text, sizeof(text), "CPU %.0f%%  ·  Memoria %.0f%%  ·  Disco %.1f MiB/s",
+                  last.cpu * 100.0f, last.memory * 100.0f, last.io_bytes_per_s / (1024.0f * 1024.0f));
+    set_tooltip_text(text);
+}
+
+void SystemLoadApplet::on_draw(const Cairo::RefPtr<Cairo::Context>& cr, int /*width*/, int height) {
+    const auto& history = system_monitor.get_history();
+    Gdk::RGBA color = get_color();
+    
+    float io_scale = IO_SCALE_MIN;
+    for (size_t i = 0; i < history.size(); ++i) {
+        io_scale = std::max(io_scale, history[i].io_bytes_per_s);
+    }
+    
+    // Una gráfica por métrica, valores normalizados a 0..1
+    auto value_at = [&](int graph, size_t i) -> double {
+        const auto& sample = history[i];
+        switch (graph) {
+            case 0: return sample.cpu;
+            case 1: return sample.memory;
+            default: return sample.io_bytes_per_s / io_scale;
+        }
+    };
+    
+    double step = static_cast<double>(GRAPH_WIDTH) / (SystemMonitor::HISTORY - 1);
+    for (int graph = 0; graph < 3; ++graph) {
+        double x0 = graph * (GRAPH_WIDTH + GRAPH_GAP);
+        
+        // Marco tenue
+        cr->set_source_rgba(color.get_red(), color.get_green(), color.get_blue(), 0.25);
+        cr->set_line_width(1.0);
+        cr->rectangle(x0 + 0.5, 0.5, GRAPH_WIDTH - 1, height - 1);
+        cr->stroke();
+        
+        if (history.size() < 2) {
+            continue;
+        }
+        // Las muestras más recientes a la derecha
+        double x = x0 + GRAPH_WIDTH - (history.size() - 1) * step;
+        cr->move_to(x, height);
+        for (size_t i = 0; i < history.size(); ++i, x += step) {
+            double value = std::clamp(value_at(graph, i), 0.0, 1.0);
+            cr->line_to(x, height - value * (height - 1));
+        }
+        cr->line_to(x - step, height);
+        cr->close_path();
+        cr->set_source_rgba(color.get_red(), color.get_green(), color.get_blue(), 0.8);
+        cr->fill();
+    }
+}
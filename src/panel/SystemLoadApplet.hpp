@@ -0,0 +1,29 @@
+// SystemLoadApplet.hpp
+#pragma once
+#include <gtkmm.h>
+#include "SystemMonitor.hpp"
+
+// Tres gráficas pequeñas (CPU, memoria, disco) con el último minuto de
+// muestras. Solo pide muestras mientras está visible.
+class SystemLoadApplet : public Gtk::DrawingArea {
+public:
+    SystemLoadApplet(SystemMonitor& system_monitor);
+    ~SystemLoadApplet();
+
+private:
+    static constexpr int GRAPH_WIDTH = 40;
+    static constexpr int GRAPH_GAP = 6;
+    static constexpr int HEIGHT = 18;
+    // Escala mínima de la gráfica de disco, en bytes/s
+    static constexpr float IO_SCALE_MIN = 1024.0f * 1024.0f;
+
+    SystemMonitor& system_monitor;
+    sigc::connection sampled_connection;
+    sigc::connection after_paint_connection;
+    int64_t frame_cpu_start_ns = 0;
+    bool sampling = false;
+
+    void on_draw(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height);
+    void on_sampled();
+    void set_sampling(bool active);
+};
@@ -0,0 +1,278 @@
+// SystemMonitor.cpp
+#include "SystemMonitor.hpp"
+#include "../utils/ProcessStats.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const char* skip_spaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+    return p;
+}
+
+uint64_t parse_number(const char*& p, const char* end) {
+    p = skip_spaces(p, end);
+    uint64_t value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + static_cast<uint64_t>(*p - '0');
+        ++p;
+    }
+    return value;
+}
+
+const char* next_line(const char* p, const char* end) {
+    const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    return newline ? newline + 1 : end;
+}
+
+bool starts_with(const char* p, const char* end, const char* prefix, size_t length) {
+    return static_cast<size_t>(end - p) >= length && std::memcmp(p, prefix, length) == 0;
+}
+
+// Dispositivos que no son discos físicos o que repiten la E/S de otro
+bool skip_device(const char* name, size_t length) {
+    return starts_with(name, name + length, "loop", 4) || starts_with(name, name + length, "ram", 3) ||
+           starts_with(name, name + length, "zram", 4) || starts_with(name, name + length, "dm-", 3) ||
+           starts_with(name, name + length, "md", 2);
+}
+
+// Diferencia de un contador acumulado; si bajó (se quitó un disco, se
+// desconectó una CPU) cuenta como cero en vez de dar la vuelta
+uint64_t counter_delta(uint64_t current, uint64_t previous) {
+    return current > previous ? current - previous : 0;
+}
+
+} // namespace
+
+SystemMonitor::SystemMonitor(TimerWheel& timer_wheel) : timer_wheel_(timer_wheel) {
+    stat_fd_ = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    meminfo_fd_ = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+    diskstats_fd_ = open("/proc/diskstats", O_RDONLY | O_CLOEXEC);
+    diskstats_buffer_.resize(16384);
+    
+    sample_ready_.open("system_sample", [this](const SampleReady& ready) { on_sample_ready(ready); });
+    
+    worker_ = std::thread(&SystemMonitor::sampler_loop, this);
+    
+    // Sin un temporizador propio: se muestrea en el mismo despertar que el reloj
+    tick_ = timer_wheel_.add(1, [this]() { request_sample(); }, false);
+}
+
+SystemMonitor::~SystemMonitor() {
+    timer_wheel_.remove(tick_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    worker_.join();
+    sample_ready_.close();
+    
+    for (int fd : {stat_fd_, meminfo_fd_, diskstats_fd_}) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+void SystemMonitor::acquire() {
+    if (users_++ > 0) {
+        return;
+    }
+    active_since_us_ = g_get_monotonic_time();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        restart_ = true;
+    }
+    // Primera lectura enseguida: la primera muestra llega en el siguiente tick
+    request_sample();
+    timer_wheel_.set_active(tick_, true);
+}
+
+void SystemMonitor::release() {
+    if (users_ == 0 || --users_ > 0) {
+        return;
+    }
+    timer_wheel_.set_active(tick_, false);
+    stats_.active_us += g_get_monotonic_time() - active_since_us_;
+}
+
+void SystemMonitor::request_sample() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++requested_;
+    }
+    wake_.notify_one();
+}
+
+const RingBuffer<SystemMonitor::Sample, SystemMonitor::HISTORY>& SystemMonitor::get_history() const {
+    return history_;
+}
+
+sigc::signal<void()>& SystemMonitor::signal_sampled() {
+    return signal_sampled_;
+}
+
+const SystemMonitor::Stats& SystemMonitor::get_stats() const {
+    return stats_;
+}
+
+void SystemMonitor::add_frame_cpu(int64_t ns) {
+    stats_.frame_cpu_ns += ns;
+}
+
+double SystemMonitor::get_self_cpu_percent() const {
+    int64_t active_us = stats_.active_us;
+    if (users_ > 0) {
+        active_us += g_get_monotonic_time() - active_since_us_;
+    }
+    if (active_us <= 0) {
+        return 0.0;
+    }
+    return (stats_.sampler_cpu_ns + stats_.frame_cpu_ns) / 1000.0 / active_us * 100.0;
+}
+
+bool SystemMonitor::read_counters(Counters& counters, float& memory) {
+    counters.taken_us = g_get_monotonic_time();
+    
+    // /proc/stat: solo la primera línea, "cpu  user nice system idle iowait irq softirq steal ..."
+    ssize_t length = pread(stat_fd_, buffer_, 512, 0);
+    if (length <= 0 || !starts_with(buffer_, buffer_ + length, "cpu ", 4)) {
+        return false;
+    }
+    const char* p = buffer_ + 4;
+    const char* end = buffer_ + length;
+    uint64_t fields[8] = {};
+    for (auto& field : fields) {
+        field = parse_number(p, end);
+    }
+    uint64_t idle = fields[3] + fields[4];
+    counters.cpu_total = 0;
+    for (auto field : fields) {
+        counters.cpu_total += field;
+    }
+    counters.cpu_busy = counters.cpu_total - idle;
+    
+    // /proc/meminfo: MemTotal y MemAvailable están en las primeras líneas
+    length = pread(meminfo_fd_, buffer_, 1024, 0);
+    if (length <= 0) {
+        return false;
+    }
+    uint64_t mem_total = 0;
+    uint64_t mem_available = 0;
+    end = buffer_ + length;
+    for (p = buffer_; p < end && (mem_total == 0 || mem_available == 0); p = next_line(p, end)) {
+        if (starts_with(p, end, "MemTotal:", 9)) {
+            const char* value = p + 9;
+            mem_total = parse_number(value, end);
+        } else if (starts_with(p, end, "MemAvailable:", 13)) {
+            const char* value = p + 13;
+            mem_available = parse_number(value, end);
+        }
+    }
+    memory = mem_total > 0 ? 1.0f - static_cast<float>(mem_available) / mem_total : 0.0f;
+    
+    // /proc/diskstats: "major minor nombre lecturas fusionadas sectores_leídos ms
+    // escrituras fusionadas sectores_escritos ..."; las particiones siguen a su
+    // disco y se saltan para no contar dos veces. Con muchos discos el archivo
+    // no cabe en una lectura: se sigue leyendo hasta el final y, si el búfer
+    // se llena, se duplica
+    size_t total = 0;
+    while (true) {
+        if (total == diskstats_buffer_.size()) {
+            diskstats_buffer_.resize(diskstats_buffer_.size() * 2);
+        }
+        length = pread(diskstats_fd_, diskstats_buffer_.data() + total, diskstats_buffer_.size() - total, total);
+        if (length <= 0) {
+            break;
+        }
+        total += length;
+    }
+    counters.disk_sectors = 0;
+    if (total > 0) {
+        const char* begin = diskstats_buffer_.data();
+        end = begin + total;
+        const char* disk_name = nullptr;
+        size_t disk_length = 0;
+        for (p = begin; p < end; p = next_line(p, end)) {
+            const char* cursor = p;
+            parse_number(cursor, end);
+            parse_number(cursor, end);
+            const char* name = skip_spaces(cursor, end);
+            cursor = name;
+            while (cursor < end && *cursor != ' ' && *cursor != '\n') {
+                ++cursor;
+            }
+            size_t name_length = cursor - name;
+            if (name_length == 0 || skip_device(name, name_length)) {
+                continue;
+            }
+            if (disk_name && name_length > disk_length && std::memcmp(name, disk_name, disk_length) == 0) {
+                continue;   // Partición del disco anterior
+            }
+            disk_name = name;
+            disk_length = name_length;
+            
+            uint64_t values[7];
+            for (auto& value : values) {
+                value = parse_number(cursor, end);
+            }
+            counters.disk_sectors += values[2] + values[6];
+        }
+    }
+    return true;
+}
+
+void SystemMonitor::sampler_loop() {
+    Counters previous;
+    bool has_previous = false;
+    uint64_t served = 0;
+    
+    while (true) {
+        {
+            // Sin applets visibles no llegan ticks y el hilo duerme aquí
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, served]() { return stopping_ || requested_ != served; });
+            if (stopping_) {
+                return;
+            }
+            served = requested_;
+            if (restart_) {
+                restart_ = false;
+                has_previous = false;
+            }
+        }
+        
+        Counters current;
+        float memory = 0.0f;
+        if (!read_counters(current, memory)) {
+            continue;
+        }
+        if (has_previous) {
+            Sample sample;
+            uint64_t total = counter_delta(current.cpu_total, previous.cpu_total);
+            uint64_t busy = std::min(counter_delta(current.cpu_busy, previous.cpu_busy), total);
+            sample.cpu = total > 0 ? static_cast<float>(busy) / total : 0.0f;
+            sample.memory = memory;
+            int64_t elapsed_us = current.taken_us - previous.taken_us;
+            sample.io_bytes_per_s = elapsed_us > 0
+                ? counter_delta(current.disk_sectors, previous.disk_sectors) * 512.0f * 1e6f / elapsed_us
+                : 0.0f;
+            sample_ready_.post(SampleReady{sample, ProcessStats::thread_cpu_ns()});
+        }
+        previous = current;
+        has_previous = true;
+    }
+}
+
+void SystemMonitor::on_sample_ready(const SampleReady& ready) {
+    history_.push(ready.sample);
+    ++stats_.samples;
+    stats_.sampler_cpu_ns = ready.sampler_cpu_ns;
+    signal_sampled_.emit();
+}
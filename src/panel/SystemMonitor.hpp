@@ -0,0 +1,97 @@
+// SystemMonitor.hpp
+#pragma once
+#include <glibmm.h>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../core/EventManager.hpp"
+#include "../core/TimerWheel.hpp"
+#include "../utils/RingBuffer.hpp"
+
+// Muestreo de CPU, memoria y disco para el applet de carga del panel.
+// /proc/stat, /proc/meminfo y /proc/diskstats se abren una vez y se releen
+// con pread en búferes reutilizados; el análisis no reserva memoria (el de
+// /proc/diskstats solo crece si una lectura no cabe). La lectura
+// se hace en un hilo propio, que despierta con el tick de un segundo de
+// TimerWheel (el mismo del reloj) mientras algún applet esté visible.
+class SystemMonitor {
+public:
+    static constexpr size_t HISTORY = 60;   // Un minuto a 1 Hz
+
+    struct Sample {
+        float cpu = 0.0f;               // Fracción ocupada, 0..1
+        float memory = 0.0f;            // Fracción usada (sin contar caché recuperable)
+        float io_bytes_per_s = 0.0f;    // Lectura + escritura de los discos
+    };
+
+    struct Stats {
+        uint64_t samples = 0;
+        int64_t sampler_cpu_ns = 0;     // CPU del hilo de muestreo
+        int64_t frame_cpu_ns = 0;       // CPU del hilo principal: muestra -> frame pintado
+        int64_t active_us = 0;          // Tiempo con el muestreo activo
+    };
+
+    explicit SystemMonitor(TimerWheel& timer_wheel);
+    ~SystemMonitor();
+
+    // Los applets avisan al mostrarse/ocultarse; sin ninguno visible no se muestrea
+    void acquire();
+    void release();
+
+    const RingBuffer<Sample, HISTORY>& get_history() const;
+    sigc::signal<void()>& signal_sampled();
+
+    // Coste propio (muestreo + frames que provoca) en % de un núcleo
+    double get_self_cpu_percent() const;
+    const Stats& get_stats() const;
+    void add_frame_cpu(int64_t ns);
+
+    SystemMonitor(const SystemMonitor&) = delete;
+    SystemMonitor& operator=(const SystemMonitor&) = delete;
+
+private:
+    // Contadores acumulados de /proc; las muestras salen de las diferencias
+    struct Counters {
+        uint64_t cpu_busy = 0;
+        uint64_t cpu_total = 0;
+        uint64_t disk_sectors = 0;
+        int64_t taken_us = 0;
+    };
+
+    // Muestra lista; llega por sample_ready_
+    struct SampleReady {
+        Sample sample;
+        int64_t sampler_cpu_ns;
+    };
+
+    void sampler_loop();
+    void request_sample();
+    bool read_counters(Counters& counters, float& memory);
+    void on_sample_ready(const SampleReady& ready);
+
+    int stat_fd_ = -1;
+    int meminfo_fd_ = -1;
+    int diskstats_fd_ = -1;
+    char buffer_[1024];                 // Solo lo usa el hilo de muestreo
+    std::vector<char> diskstats_buffer_; // Ídem; crece con el número de discos
+
+    TimerWheel& timer_wheel_;
+    TimerWheel::Id tick_ = 0;
+    unsigned int users_ = 0;            // Hilo principal
+
+    // Peticiones al hilo de muestreo, protegidas por mutex_
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    uint64_t requested_ = 0;            // Avanza con cada tick
+    bool restart_ = false;              // Tras una pausa la muestra anterior no vale
+    bool stopping_ = false;
+
+    RingBuffer<Sample, HISTORY> history_;
+    Stats stats_;
+    int64_t active_since_us_ = 0;
+    WorkerResults<SampleReady> sample_ready_;
+    sigc::signal<void()> signal_sampled_;
+};
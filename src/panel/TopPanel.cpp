@@ -5,44 +5,30 @@
 #include <sstream>
 #include <gdkmm/monitor.h>
 #include <glibmm/refptr.h>
-#include <gdkmm/display.h>
-#include "../config/ThemeManager.hpp"
 #include "../app_launcher/AppLauncher.hpp"  
 
-// para aplicar los temas
-#include "../config/ThemeManager.hpp"
-
-TopPanel::TopPanel() : box(Gtk::Orientation::HORIZONTAL) {
+TopPanel::TopPanel(const Glib::RefPtr<Gdk::Monitor>& monitor, IconService& icon_service,
+                   TimerWheel& timer_wheel, SystemMonitor& system_monitor)
+    : box(Gtk::Orientation::HORIZONTAL), timer_wheel(timer_wheel), load_applet(system_monitor),
+      monitor(monitor) {
     set_decorated(false);
     set_resizable(false);
     set_title("Panel Superior");
+    add_css_class("top-panel");
     
-    // Obtener el tamaño de la pantalla
-    auto display = Gdk::Display::get_default();
-    if (display) {
-        auto monitors = display->get_monitors();
-        if (monitors && monitors->get_n_items() > 0) {
-            auto monitor_obj = monitors->get_object(0);
-            auto monitor = std::dynamic_pointer_cast<Gdk::Monitor>(monitor_obj);
-            if (monitor) {
-                Gdk::Rectangle geometry;
-                monitor->get_geometry(geometry);
-                set_default_size(geometry.get_width(), 30);
-            } else {
-                set_default_size(800, 30); // Fallback
-            }
-        } else {
-            set_default_size(800, 30); // Fallback
-        }
+    // Ancho del monitor al que pertenece este panel
+    if (monitor) {
+        Gdk::Rectangle geometry;
+        monitor->get_geometry(geometry);
+        set_default_size(geometry.get_width(), 30);
     } else {
         set_default_size(800, 30); // Fallback
     }
     
-    // Eliminado: Creación redundante de ThemeManager
-    // El tema se aplicará externamente via apply_theme()
-    
     // Configurar botón de menú
-    menu_button.set_label("☰");
+    icon_service.load_into(menu_icon, "view-app-grid-symbolic", 16);
+    menu_button.set_child(menu_icon);
+    menu_button.set_tooltip_text("Aplicaciones");
     menu_button.set_margin_end(10);
 
     menu_button.signal_clicked().connect([this]() {
@@ -60,39 +46,32 @@ TopPanel::TopPanel() : box(Gtk::Orientation::HORIZONTAL) {
     // Agregar elementos al box
     box.append(menu_button);
     box.append(clock);
+    load_applet.set_margin_start(10);
+    load_applet.set_margin_end(10);
+    box.append(load_applet);
     
     set_child(box);
     
-    // Configurar timer
-    timer_connection = Glib::signal_timeout().connect_seconds(
-        sigc::mem_fun(*this, &TopPanel::update_time), 1
-    );
+    // Reloj en el cambio exacto de segundo; oculto no despierta al proceso
+    clock_timer = timer_wheel.add(1, [this]() { update_time(); }, false);
+    signal_map().connect([this]() {
+        update_time();
+        this->timer_wheel.set_active(clock_timer, true);
+    });
+    signal_unmap().connect([this]() {
+        this->timer_wheel.set_active(clock_timer, false);
+    });
 }
 
 TopPanel::~TopPanel() {
-    // Importante: Desconectar señal del timer
-    timer_connection.disconnect();
+    timer_wheel.remove(clock_timer);
 }
 
 void TopPanel::set_app_launcher(AppLauncher* launcher) {
     app_launcher = launcher;
 }
 
-void TopPanel::apply_theme(ThemeManager* theme) {
-    auto context = get_style_context();
-    
-    // Limpiar proveedor anterior
-    if (current_provider) {
-        context->remove_provider(current_provider);
-    }
-    
-    current_provider = theme->get_component_provider("top-panel");
-    if (current_provider) {
-        context->add_provider(current_provider, GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
-    }
-}
-
-bool TopPanel::update_time() {
+void TopPanel::update_time() {
     auto now = std::chrono::system_clock::now();
     auto in_time_t = std::chrono::system_clock::to_time_t(now);
     std::tm tm_buf;
@@ -101,5 +80,4 @@ bool TopPanel::update_time() {
     std::ostringstream oss;
     oss << std::put_time(&tm_buf, "%H:%M:%S");
     clock.set_text(oss.str());
-    return true; // Mantener activo
 }
\ No newline at end of file
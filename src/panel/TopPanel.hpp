@@ -1,27 +1,32 @@
 // TopPanel.hpp
 #pragma once
-#include "../config/ThemeManager.hpp"
 #include <gtkmm.h>
+#include "../core/IconService.hpp"
+#include "../core/TimerWheel.hpp"
+#include "SystemLoadApplet.hpp"
 
 class AppLauncher; // Declaración adelantada
 
 class TopPanel : public Gtk::Window {
 public:
-    TopPanel();
+    TopPanel(const Glib::RefPtr<Gdk::Monitor>& monitor, IconService& icon_service, TimerWheel& timer_wheel,
+             SystemMonitor& system_monitor);
     ~TopPanel();
     
     void set_app_launcher(AppLauncher* launcher); // Puntero sin ownership
-    void apply_theme(ThemeManager* theme);
+    Glib::RefPtr<Gdk::Monitor> get_monitor() const { return monitor; }
 
 private:
     Gtk::Box box;
     Gtk::Label clock;
-    sigc::connection timer_connection;
-    bool update_time();
+    TimerWheel& timer_wheel;
+    TimerWheel::Id clock_timer = 0;     // Solo activo mientras el panel está mapeado
+    void update_time();
+    
+    SystemLoadApplet load_applet;
     
     Gtk::Button menu_button;
+    Gtk::Image menu_icon;
     AppLauncher* app_launcher = nullptr; // Puntero observador (no propietario)
-
-    // Para manejar CSS
-    Glib::RefPtr<Gtk::CssProvider> current_provider;
+    Glib::RefPtr<Gdk::Monitor> monitor;
 };
\ No newline at end of file
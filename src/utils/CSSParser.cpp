@@ -1,35 +1,348 @@
 // CCSParser.cpp
 #include "CSSParser.hpp"
+#include "../core/Tracer.hpp"
+#include <algorithm>
+
+namespace {
+
+bool is_name_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_' || c == '-';
+}
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && is_space(s.front())) s.remove_prefix(1);
+    while (!s.empty() && is_space(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+// Copia desde css[i] (que es '{') hasta su '}' de cierre incluido
+size_t skip_block(std::string_view css, size_t i) {
+    int depth = 0;
+    char quote = 0;
+    for (; i < css.size(); ++i) {
+        char c = css[i];
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '{') {
+            ++depth;
+        } else if (c == '}') {
+            if (--depth == 0) return i + 1;
+        }
+    }
+    return css.size();
+}
+
+// ¿Aparece ".clase" como clase completa (no como prefijo de otra)?
+bool has_class(std::string_view selector, std::string_view class_name) {
+    size_t pos = 0;
+    while ((pos = selector.find(class_name, pos)) != std::string_view::npos) {
+        size_t end = pos + class_name.size();
+        bool starts = pos > 0 && selector[pos - 1] == '.';
+        bool ends = end >= selector.size() || !is_name_char(selector[end]);
+        if (starts && ends) return true;
+        pos = end;
+    }
+    return false;
+}
+
+} // namespace
 
 std::string CSSParser::parse(const std::string& css, const nlohmann::json& variables) {
-    std::string result = css;
-    
-    // Expresión regular para encontrar variables CSS: var(--variable-name)
-    std::regex var_regex(R"(var\((--[a-zA-Z0-9_-]+)\))");
-    std::smatch matches;
-    
-    std::string::const_iterator search_start = css.cbegin();
-    while (std::regex_search(search_start, css.cend(), matches, var_regex)) {
-        std::string full_match = matches[0];
-        std::string var_name = matches[1];
-        
-        // Buscar el valor en las variables globales
-        std::string replacement;
-        if (variables.contains(var_name.substr(2))) { // Eliminar '--' del nombre
-            replacement = variables[var_name.substr(2)].get<std::string>();
+    TraceSpan span("CSSParser::parse");
+    std::string result;
+    // Los valores suelen ser algo más largos que "var(--x)", reservar un margen
+    result.reserve(css.size() + css.size() / 4);
+    substitute(css, variables, result, 0);
+    return result;
+}
+
+CSSTemplate CSSParser::compile(std::string_view css) const {
+    CSSTemplate tmpl;
+    VarRef ref;
+    size_t pos = 0;
+
+    while (next_var(css, pos, ref)) {
+        if (ref.begin > pos) {
+            CSSTemplate::Segment literal;
+            literal.text.assign(css.substr(pos, ref.begin - pos));
+            tmpl.literal_size += literal.text.size();
+            tmpl.segments.push_back(std::move(literal));
+        }
+
+        CSSTemplate::Segment slot;
+        slot.is_variable = true;
+        slot.text.assign(ref.name);
+        slot.has_fallback = ref.has_fallback;
+        slot.fallback.assign(ref.fallback);
+        tmpl.segments.push_back(std::move(slot));
+
+        if (std::find(tmpl.variables.begin(), tmpl.variables.end(), ref.name) == tmpl.variables.end()) {
+            tmpl.variables.emplace_back(ref.name);
+        }
+        if (ref.has_fallback) {
+            collect_variables(ref.fallback, tmpl.variables);
+        }
+
+        pos = ref.end;
+    }
+
+    if (pos < css.size()) {
+        CSSTemplate::Segment literal;
+        literal.text.assign(css.substr(pos));
+        tmpl.literal_size += literal.text.size();
+        tmpl.segments.push_back(std::move(literal));
+    }
+
+    return tmpl;
+}
+
+std::string CSSParser::render(const CSSTemplate& tmpl, const nlohmann::json& variables) {
+    TraceSpan span("CSSParser::render");
+    std::string result;
+    result.reserve(tmpl.literal_size + tmpl.literal_size / 4);
+
+    for (const auto& segment : tmpl.segments) {
+        if (segment.is_variable) {
+            resolve(segment.text, segment.fallback, segment.has_fallback, variables, result, 0);
         } else {
-            // Valor por defecto si no se encuentra
-            replacement = "inherit";
+            result.append(segment.text);
+        }
+    }
+    return result;
+}
+
+std::string CSSParser::scope(std::string_view css, const std::string& scope_class) const {
+    std::string result;
+    result.reserve(css.size() + css.size() / 2);
+    scope_rules(css, scope_class, result);
+    return result;
+}
+
+void CSSParser::scope_rules(std::string_view css, const std::string& scope_class, std::string& result) {
+    size_t i = 0;
+    while (i < css.size()) {
+        // Espacios y comentarios entre reglas
+        if (is_space(css[i])) {
+            result.push_back(css[i++]);
+            continue;
+        }
+        if (css.compare(i, 2, "/*") == 0) {
+            size_t end = css.find("*/", i + 2);
+            end = (end == std::string_view::npos) ? css.size() : end + 2;
+            result.append(css.substr(i, end - i));
+            i = end;
+            continue;
         }
         
-        // Reemplazar en el resultado
-        size_t pos = result.find(full_match);
-        if (pos != std::string::npos) {
-            result.replace(pos, full_match.length(), replacement);
+        size_t brace = css.find('{', i);
+        if (css[i] == '@') {
+            // @define-color ...;
+            size_t semicolon = css.find(';', i);
+            if (brace == std::string_view::npos || (semicolon != std::string_view::npos && semicolon < brace)) {
+                size_t end = semicolon == std::string_view::npos ? css.size() : semicolon + 1;
+                result.append(css.substr(i, end - i));
+                i = end;
+                continue;
+            }
+            
+            size_t end = skip_block(css, brace);
+            std::string_view prelude = css.substr(i, brace - i);
+            if (prelude.compare(0, 6, "@media") == 0 || prelude.compare(0, 9, "@supports") == 0) {
+                // Reglas condicionales: sus reglas internas también se limitan
+                result.append(prelude);
+                result.push_back('{');
+                size_t inner_end = (end > brace + 1 && css[end - 1] == '}') ? end - 1 : end;
+                scope_rules(css.substr(brace + 1, inner_end - brace - 1), scope_class, result);
+                result.push_back('}');
+            } else {
+                // @keyframes y demás: su contenido no son selectores
+                result.append(css.substr(i, end - i));
+            }
+            i = end;
+            continue;
         }
+        if (brace == std::string_view::npos) {
+            result.append(css.substr(i));
+            break;
+        }
+        
+        // Lista de selectores separada por comas de primer nivel
+        std::string_view selectors = css.substr(i, brace - i);
+        size_t start = 0;
+        int parens = 0;
+        bool first = true;
+        for (size_t k = 0; k <= selectors.size(); ++k) {
+            if (k < selectors.size()) {
+                char c = selectors[k];
+                if (c == '(' || c == '[') ++parens;
+                else if (c == ')' || c == ']') --parens;
+                if (c != ',' || parens > 0) continue;
+            }
+            std::string_view selector = trim(selectors.substr(start, k - start));
+            start = k + 1;
+            if (!first) result.append(", ");
+            first = false;
+            if (selector.empty() || has_class(selector, scope_class)) {
+                result.append(selector);
+                continue;
+            }
+            // La regla vale para la raíz del componente (window.top-panel)
+            // y para sus descendientes (.top-panel window)
+            append_compound_scoped(selector, scope_class, result);
+            result.append(", .");
+            result.append(scope_class);
+            result.push_back(' ');
+            result.append(selector);
+        }
+        result.push_back(' ');
         
-        search_start = matches.suffix().first;
+        size_t end = skip_block(css, brace);
+        result.append(css.substr(brace, end - brace));
+        i = end;
     }
-    
-    return result;
-}
\ No newline at end of file
+}
+
+void CSSParser::append_compound_scoped(std::string_view selector, const std::string& scope_class,
+                                       std::string& result) {
+    // Fin del primer selector compuesto: primer combinador de primer nivel
+    size_t end = 0;
+    int parens = 0;
+    for (; end < selector.size(); ++end) {
+        char c = selector[end];
+        if (c == '(' || c == '[') ++parens;
+        else if (c == ')' || c == ']') --parens;
+        else if (parens == 0 && (is_space(c) || c == '>' || c == '+' || c == '~')) break;
+    }
+    // La clase va antes de un pseudo-elemento, que debe ser lo último
+    std::string_view compound = selector.substr(0, end);
+    size_t insert = compound.find("::");
+    if (insert == std::string_view::npos) {
+        insert = compound.size();
+    }
+    result.append(selector.substr(0, insert));
+    result.push_back('.');
+    result.append(scope_class);
+    result.append(selector.substr(insert));
+}
+
+void CSSParser::collect_variables(std::string_view css, std::vector<std::string>& names) {
+    VarRef ref;
+    size_t pos = 0;
+    while (next_var(css, pos, ref)) {
+        if (std::find(names.begin(), names.end(), ref.name) == names.end()) {
+            names.emplace_back(ref.name);
+        }
+        if (ref.has_fallback) {
+            collect_variables(ref.fallback, names);
+        }
+        pos = ref.end;
+    }
+}
+
+bool CSSParser::next_var(std::string_view css, size_t pos, VarRef& ref) {
+    while (pos < css.size()) {
+        size_t start = css.find("var(", pos);
+        if (start == std::string_view::npos) {
+            return false;
+        }
+        // Si la referencia está mal formada se deja literal y se sigue buscando
+        pos = start + 4;
+
+        // var( --nombre
+        size_t i = start + 4;
+        while (i < css.size() && is_space(css[i])) ++i;
+        if (css.compare(i, 2, "--") != 0) {
+            continue;
+        }
+        size_t name_begin = i + 2;
+        i = name_begin;
+        while (i < css.size() && is_name_char(css[i])) ++i;
+        std::string_view name = css.substr(name_begin, i - name_begin);
+        while (i < css.size() && is_space(css[i])) ++i;
+
+        // Fallback opcional hasta el paréntesis de cierre equilibrado
+        std::string_view fallback;
+        bool has_fallback = false;
+        if (i < css.size() && css[i] == ',') {
+            size_t fb_begin = ++i;
+            int parens = 0;
+            char quote = 0;
+            for (; i < css.size(); ++i) {
+                char c = css[i];
+                if (quote) {
+                    if (c == quote) quote = 0;
+                } else if (c == '"' || c == '\'') {
+                    quote = c;
+                } else if (c == '(') {
+                    ++parens;
+                } else if (c == ')') {
+                    if (parens == 0) break;
+                    --parens;
+                }
+            }
+            fallback = trim(css.substr(fb_begin, i - fb_begin));
+            has_fallback = true;
+        }
+
+        if (name.empty() || i >= css.size() || css[i] != ')') {
+            continue;
+        }
+
+        ref.begin = start;
+        ref.end = i + 1;
+        ref.name = name;
+        ref.fallback = fallback;
+        ref.has_fallback = has_fallback;
+        return true;
+    }
+    return false;
+}
+
+void CSSParser::substitute(std::string_view css, const nlohmann::json& variables,
+                           std::string& out, int depth) {
+    VarRef ref;
+    size_t pos = 0;
+    while (next_var(css, pos, ref)) {
+        out.append(css.substr(pos, ref.begin - pos));
+        resolve(ref.name, ref.fallback, ref.has_fallback, variables, out, depth);
+        pos = ref.end;
+    }
+    if (pos < css.size()) {
+        out.append(css.substr(pos));
+    }
+}
+
+void CSSParser::resolve(std::string_view name, std::string_view fallback, bool has_fallback,
+                        const nlohmann::json& variables, std::string& out, int depth) {
+    if (depth >= MAX_DEPTH) {
+        out.append("inherit");
+        return;
+    }
+
+    // Buscar el valor en las variables globales (sin el prefijo '--')
+    auto it = variables.is_object() ? variables.find(std::string(name)) : variables.end();
+    if (it != variables.end() && !it->is_null()) {
+        if (it->is_string()) {
+            // El valor puede a su vez referenciar otras variables
+            const auto& value = it->get_ref<const std::string&>();
+            substitute(value, variables, out, depth + 1);
+        } else {
+            out.append(it->dump());
+        }
+        return;
+    }
+
+    if (has_fallback) {
+        substitute(fallback, variables, out, depth + 1);
+    } else {
+        // Valor por defecto si no se encuentra
+        out.append("inherit");
+    }
+}
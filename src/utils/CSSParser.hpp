@@ -2,9 +2,63 @@
 #pragma once
 #include <nlohmann/json.hpp>
 #include <string>
-#include <regex>
+#include <string_view>
+#include <vector>
 
+// Hoja de estilos precompilada: tramos literales intercalados con huecos de
+// variables. Renderizarla es solo concatenar, sin volver a escanear el CSS.
+struct CSSTemplate {
+    struct Segment {
+        std::string text;           // Literal, o nombre de variable (sin '--')
+        std::string fallback;       // Valor alternativo de var(--x, fallback)
+        bool is_variable = false;
+        bool has_fallback = false;
+    };
+
+    std::vector<Segment> segments;
+    std::vector<std::string> variables; // Variables referenciadas (incluidas las de fallbacks)
+    size_t literal_size = 0;        // Suma de los literales, para reservar al renderizar
+};
+
+// Sustituye var(--nombre) y var(--nombre, fallback) por los valores globales
+// del tema en una sola pasada, escribiendo en un único buffer de salida.
 class CSSParser {
 public:
     std::string parse(const std::string& css, const nlohmann::json& variables);
-};
\ No newline at end of file
+
+    CSSTemplate compile(std::string_view css) const;
+    std::string render(const CSSTemplate& tmpl, const nlohmann::json& variables);
+
+    // Limita cada regla al componente: un selector que no nombra ya la clase
+    // .scope_class pasa a valer para la raíz (sel.scope_class) y para sus
+    // descendientes (.scope_class sel). Dentro de @media y @supports también;
+    // el resto de reglas @ se copian tal cual.
+    std::string scope(std::string_view css, const std::string& scope_class) const;
+
+    // Añade a names (sin repetir) las variables que referencia css
+    static void collect_variables(std::string_view css, std::vector<std::string>& names);
+
+private:
+    struct VarRef {
+        size_t begin = 0;           // Posición de "var("
+        size_t end = 0;             // Posición tras el ')' de cierre
+        std::string_view name;
+        std::string_view fallback;
+        bool has_fallback = false;
+    };
+
+    // Profundidad máxima de variables anidadas (evita ciclos a -> b -> a)
+    static constexpr int MAX_DEPTH = 16;
+
+    static void scope_rules(std::string_view css, const std::string& scope_class, std::string& result);
+    static void append_compound_scoped(std::string_view selector, const std::string& scope_class,
+                                       std::string& result);
+
+    // Busca la siguiente referencia var(--x[, fallback]) válida desde pos
+    static bool next_var(std::string_view css, size_t pos, VarRef& ref);
+
+    void substitute(std::string_view css, const nlohmann::json& variables,
+                    std::string& out, int depth);
+    void resolve(std::string_view name, std::string_view fallback, bool has_fallback,
+                 const nlohmann::json& variables, std::string& out, int depth);
+};
@@ -0,0 +1,51 @@
+// CSSTemplateCache.cpp
+#include "CSSTemplateCache.hpp"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+std::shared_ptr<const CSSTemplate> CSSTemplateCache::get(const std::string& css_path) {
+    std::error_code ec;
+    auto mtime = fs::last_write_time(css_path, ec);
+    if (ec) {
+        std::cerr << "Archivo CSS no encontrado: " << css_path << std::endl;
+        entries_.erase(css_path);
+        return nullptr;
+    }
+    auto size = fs::file_size(css_path, ec);
+
+    auto it = entries_.find(css_path);
+    if (it != entries_.end() && it->second.mtime == mtime && it->second.size == size) {
+        return it->second.tmpl;
+    }
+
+    std::ifstream css_file(css_path);
+    if (!css_file) {
+        std::cerr << "No se pudo abrir " << css_path << std::endl;
+        return nullptr;
+    }
+    std::stringstream buffer;
+    buffer << css_file.rdbuf();
+    std::string css_content = buffer.str();
+    size_t content_hash = std::hash<std::string>{}(css_content);
+
+    auto& entry = entries_[css_path];
+    entry.mtime = mtime;
+    entry.size = size;
+    // Archivo "tocado" pero con el mismo contenido: conservar la plantilla
+    if (!entry.tmpl || entry.content_hash != content_hash) {
+        entry.content_hash = content_hash;
+        entry.tmpl = std::make_shared<CSSTemplate>(compiler_.compile(css_content));
+    }
+    return entry.tmpl;
+}
+
+void CSSTemplateCache::invalidate(const std::string& css_path) {
+    entries_.erase(css_path);
+}
+
+void CSSTemplateCache::clear() {
+    entries_.clear();
+}
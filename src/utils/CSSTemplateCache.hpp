@@ -0,0 +1,30 @@
+// CSSTemplateCache.hpp
+#pragma once
+#include "CSSParser.hpp"
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Caché de hojas de estilo compiladas, indexada por ruta. Una entrada se
+// reutiliza mientras no cambien mtime/tamaño del archivo; si cambian, se
+// relee y solo se recompila cuando el contenido (hash) es realmente distinto.
+class CSSTemplateCache {
+public:
+    // Devuelve la plantilla del archivo, o nullptr si no se puede leer
+    std::shared_ptr<const CSSTemplate> get(const std::string& css_path);
+
+    void invalidate(const std::string& css_path);
+    void clear();
+
+private:
+    struct Entry {
+        std::filesystem::file_time_type mtime;
+        std::uintmax_t size = 0;
+        size_t content_hash = 0;
+        std::shared_ptr<const CSSTemplate> tmpl;
+    };
+
+    std::unordered_map<std::string, Entry> entries_;
+    CSSParser compiler_;
+};
@@ -0,0 +1,35 @@
+// Histogram.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Histograma de duraciones en microsegundos con cubos fijos (de 100 us a
+// 1 s); registrar un valor no reserva memoria.
+class Histogram {
+public:
+    static constexpr std::array<int64_t, 10> BOUNDS_US = {
+        100, 250, 500, 1000, 2500, 5000, 10000, 50000, 250000, 1000000
+    };
+
+    void record(int64_t value_us) {
+        size_t bucket = 0;
+        while (bucket < BOUNDS_US.size() && value_us > BOUNDS_US[bucket]) {
+            ++bucket;
+        }
+        ++buckets_[bucket];
+        ++count_;
+        sum_us_ += value_us;
+    }
+
+    // Cubo i: valores <= BOUNDS_US[i]; el último, los mayores que todos
+    uint64_t bucket(size_t index) const { return buckets_[index]; }
+    static constexpr size_t bucket_count() { return BOUNDS_US.size() + 1; }
+    uint64_t count() const { return count_; }
+    int64_t sum_us() const { return sum_us_; }
+
+private:
+    std::array<uint64_t, BOUNDS_US.size() + 1> buckets_{};
+    uint64_t count_ = 0;
+    int64_t sum_us_ = 0;
+};
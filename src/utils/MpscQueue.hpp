@@ -0,0 +1,62 @@
+// MpscQueue.hpp
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// Cola sin bloqueos de varios productores y un consumidor. Los productores
+// solo hacen un compare-exchange sobre la cabeza; el consumidor se lleva la
+// lista entera de una vez y la recorre en orden de llegada.
+template<typename T>
+class MpscQueue {
+public:
+    MpscQueue() = default;
+    ~MpscQueue() {
+        drain([](T&&) {});
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Seguro desde cualquier hilo
+    void push(T value) {
+        Node* node = new Node{std::move(value), head_.load(std::memory_order_relaxed)};
+        while (!head_.compare_exchange_weak(node->next, node,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+        }
+    }
+
+    // Solo desde el hilo consumidor. Devuelve cuántos elementos procesó
+    template<typename Consumer>
+    size_t drain(Consumer&& consumer) {
+        Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+        
+        // La pila queda al revés: darle la vuelta para entregar en orden FIFO
+        Node* ordered = nullptr;
+        while (node) {
+            Node* next = node->next;
+            node->next = ordered;
+            ordered = node;
+            node = next;
+        }
+        
+        size_t count = 0;
+        while (ordered) {
+            Node* next = ordered->next;
+            consumer(std::move(ordered->value));
+            delete ordered;
+            ordered = next;
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    struct Node {
+        T value;
+        Node* next;
+    };
+
+    std::atomic<Node*> head_{nullptr};
+};
@@ -0,0 +1,30 @@
+// ProcessStats.cpp
+#include "ProcessStats.hpp"
+#include <cstdio>
+#include <ctime>
+#include <unistd.h>
+
+namespace ProcessStats {
+
+size_t rss_bytes() {
+    // statm: tamaño total y residente, en páginas
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file) {
+        return 0;
+    }
+    unsigned long total = 0, resident = 0;
+    int fields = std::fscanf(file, "%lu %lu", &total, &resident);
+    std::fclose(file);
+    if (fields != 2) {
+        return 0;
+    }
+    return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+int64_t thread_cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+} // namespace ProcessStats
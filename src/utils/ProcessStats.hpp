@@ -0,0 +1,15 @@
+// ProcessStats.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Datos del propio proceso leídos de /proc
+namespace ProcessStats {
+
+    // Memoria residente (RSS) en bytes; 0 si no se puede leer
+    size_t rss_bytes();
+
+    // CPU consumida por el hilo que llama, en ns
+    int64_t thread_cpu_ns();
+
+} // namespace ProcessStats
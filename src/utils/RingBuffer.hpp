@@ -0,0 +1,32 @@
+// RingBuffer.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+
+// Historial de tamaño fijo: al llenarse, cada push sustituye al más antiguo.
+// Sin reservas de memoria después de construirse.
+template <typename T, size_t N>
+class RingBuffer {
+public:
+    void push(const T& value) {
+        data_[(start_ + size_) % N] = value;
+        if (size_ < N) {
+            ++size_;
+        } else {
+            start_ = (start_ + 1) % N;
+        }
+    }
+
+    // 0 es el más antiguo
+    const T& operator[](size_t index) const { return data_[(start_ + index) % N]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    std::array<T, N> data_{};
+    size_t start_ = 0;
+    size_t size_ = 0;
+};
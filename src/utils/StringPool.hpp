@@ -0,0 +1,54 @@
+// StringPool.hpp
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Cadenas internadas en un único buffer contiguo. Cada cadena se guarda una
+// sola vez, terminada en '\0', y se identifica por su desplazamiento: los
+// identificadores ocupan 4 bytes y siguen siendo válidos aunque el buffer crezca.
+class StringPool {
+public:
+    using Id = uint32_t;
+    static constexpr Id EMPTY = 0;  // La cadena vacía siempre está en el desplazamiento 0
+
+    StringPool() {
+        data_.push_back('\0');
+    }
+
+    Id intern(std::string_view text) {
+        if (text.empty()) {
+            return EMPTY;
+        }
+        
+        size_t hash = std::hash<std::string_view>{}(text);
+        auto range = lookup_.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (get(it->second) == text) {
+                return it->second;
+            }
+        }
+        
+        Id id = static_cast<Id>(data_.size());
+        data_.append(text.data(), text.size());
+        data_.push_back('\0');
+        lookup_.emplace(hash, id);
+        return id;
+    }
+
+    std::string_view get(Id id) const {
+        return std::string_view(data_.c_str() + id);
+    }
+
+    // Buffer completo, con todas las cadenas seguidas
+    const char* data() const { return data_.c_str(); }
+    size_t size_bytes() const { return data_.size(); }
+    size_t count() const { return lookup_.size(); }
+
+private:
+    std::string data_;
+    std::unordered_multimap<size_t, Id> lookup_;    // hash -> desplazamiento
+};
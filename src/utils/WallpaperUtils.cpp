@@ -0,0 +1,38 @@
+// WallpaperUtils.cpp
+#include "WallpaperUtils.hpp"
+#include <algorithm>
+
+namespace WallpaperUtils {
+
+void cover_size(int src_width, int src_height, int target_width, int target_height,
+                int& out_width, int& out_height) {
+    out_width = src_width;
+    out_height = src_height;
+    if (src_width <= 0 || src_height <= 0 || target_width <= 0 || target_height <= 0) {
+        return;
+    }
+    
+    double scale = std::max(static_cast<double>(target_width) / src_width,
+                            static_cast<double>(target_height) / src_height);
+    if (scale >= 1.0) {
+        return;
+    }
+    out_width = std::max(1, static_cast<int>(src_width * scale + 0.5));
+    out_height = std::max(1, static_cast<int>(src_height * scale + 0.5));
+}
+
+Glib::RefPtr<Gdk::Pixbuf> load_scaled(const std::string& path, int target_width, int target_height) {
+    int src_width = 0;
+    int src_height = 0;
+    if (!gdk_pixbuf_get_file_info(path.c_str(), &src_width, &src_height)) {
+        // Formato desconocido: dejar que create_from_file informe del error
+        return Gdk::Pixbuf::create_from_file(path);
+    }
+    
+    int width = 0;
+    int height = 0;
+    cover_size(src_width, src_height, target_width, target_height, width, height);
+    return Gdk::Pixbuf::create_from_file(path, width, height, true);
+}
+
+} // namespace WallpaperUtils
@@ -0,0 +1,20 @@
+// WallpaperUtils.hpp
+#pragma once
+#include <gdkmm/pixbuf.h>
+#include <string>
+
+// Decodificación de fondos de pantalla. Estas funciones no tocan GTK y se
+// pueden llamar desde un hilo de trabajo (gdk-pixbuf es seguro entre hilos).
+namespace WallpaperUtils {
+
+    // Tamaño al que escalar src para cubrir target (como ContentFit::COVER)
+    // sin ampliar nunca la imagen original
+    void cover_size(int src_width, int src_height, int target_width, int target_height,
+                    int& out_width, int& out_height);
+
+    // Decodifica la imagen directamente al tamaño de destino; el cargador de
+    // JPEG escala durante el decode, sin pasar por la resolución completa.
+    // Lanza Glib::Error si el archivo no se puede leer.
+    Glib::RefPtr<Gdk::Pixbuf> load_scaled(const std::string& path, int target_width, int target_height);
+
+} // namespace WallpaperUtils
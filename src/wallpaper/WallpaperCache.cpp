@@ -0,0 +1,243 @@
+// WallpaperCache.cpp
+#include "WallpaperCache.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char CACHE_MAGIC[8] = {'E', 'N', 'T', 'W', 'P', 'C', 'H', '\0'};
+constexpr uint32_t CACHE_VERSION = 1;
+
+struct EntryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    uint32_t has_alpha;
+    uint32_t path_length;           // Ruta de origen guardada tras la cabecera
+    int64_t source_mtime_ns;
+    uint64_t source_size;
+    uint64_t data_offset;
+    uint64_t data_size;
+};
+
+struct Mapping {
+    void* address;
+    size_t length;
+};
+
+void unmap(gpointer data) {
+    auto* mapping = static_cast<Mapping*>(data);
+    munmap(mapping->address, mapping->length);
+    delete mapping;
+}
+
+bool write_all(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+WallpaperCache::WallpaperCache(uint64_t max_bytes)
+    : cache_dir_(Glib::get_user_cache_dir() + "/entorno/wallpapers"), max_bytes_(max_bytes) {
+    std::error_code ec;
+    fs::create_directories(cache_dir_, ec);
+    if (ec) {
+        std::cerr << "No se pudo crear la caché de fondos " << cache_dir_ << ": " << ec.message() << std::endl;
+    }
+}
+
+bool WallpaperCache::stat_source(const std::string& path, SourceInfo& info) const {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    info.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    info.size = static_cast<uint64_t>(st.st_size);
+    return true;
+}
+
+std::string WallpaperCache::entry_path(const std::string& path, const SourceInfo& info,
+                                       int width, int height) const {
+    std::string key = path + '\n' + std::to_string(info.mtime_ns) + '\n' + std::to_string(info.size) +
+                      '\n' + std::to_string(width) + 'x' + std::to_string(height);
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016zx.px", std::hash<std::string>{}(key));
+    return cache_dir_ + "/" + name;
+}
+
+bool WallpaperCache::lookup(const std::string& path, int width, int height, Image& image) {
+    SourceInfo info;
+    if (!stat_source(path, info)) {
+        return false;
+    }
+    std::string file_path = entry_path(path, info, width, height);
+    
+    int fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(EntryHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size_t length = static_cast<size_t>(st.st_size);
+    void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    
+    // Validar la entrada antes de entregarla: cabecera, origen y tamaño de datos
+    EntryHeader header;
+    std::memcpy(&header, address, sizeof(header));
+    const char* stored_path = static_cast<const char*>(address) + sizeof(EntryHeader);
+    bool valid = std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+                 header.version == CACHE_VERSION &&
+                 header.source_mtime_ns == info.mtime_ns &&
+                 header.source_size == info.size &&
+                 header.width > 0 && header.height > 0 &&
+                 header.stride >= header.width * (header.has_alpha ? 4u : 3u) &&
+                 sizeof(EntryHeader) + header.path_length <= header.data_offset &&
+                 header.data_offset + header.data_size == length &&
+                 header.data_size >= static_cast<uint64_t>(header.stride) * header.height &&
+                 header.path_length == path.size() &&
+                 std::memcmp(stored_path, path.data(), path.size()) == 0;
+    if (!valid) {
+        munmap(address, length);
+        std::cerr << "Entrada de caché inválida, eliminando: " << file_path << std::endl;
+        ::unlink(file_path.c_str());
+        return false;
+    }
+    
+    // Marcar como usada recientemente para la expulsión LRU
+    ::utimensat(AT_FDCWD, file_path.c_str(), nullptr, 0);
+    
+    auto* mapping = new Mapping{address, length};
+    GBytes* bytes = g_bytes_new_with_free_func(static_cast<const char*>(address) + header.data_offset,
+                                               header.data_size, &unmap, mapping);
+    image.pixels = Glib::wrap(bytes);
+    image.width = static_cast<int>(header.width);
+    image.height = static_cast<int>(header.height);
+    image.stride = header.stride;
+    image.has_alpha = header.has_alpha != 0;
+    return true;
+}
+
+void WallpaperCache::store(const std::string& path, int width, int height,
+                           const Glib::RefPtr<Gdk::Pixbuf>& pixbuf) {
+    SourceInfo info;
+    if (!pixbuf || !stat_source(path, info) || pixbuf->get_bits_per_sample() != 8) {
+        return;
+    }
+    
+    bool has_alpha = pixbuf->get_has_alpha();
+    uint32_t channels = has_alpha ? 4 : 3;
+    if (static_cast<uint32_t>(pixbuf->get_n_channels()) != channels) {
+        return;
+    }
+    
+    EntryHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.width = static_cast<uint32_t>(pixbuf->get_width());
+    header.height = static_cast<uint32_t>(pixbuf->get_height());
+    header.stride = header.width * channels;
+    header.has_alpha = has_alpha ? 1 : 0;
+    header.path_length = static_cast<uint32_t>(path.size());
+    header.source_mtime_ns = info.mtime_ns;
+    header.source_size = info.size;
+    // Datos alineados a 16 bytes tras la ruta
+    header.data_offset = (sizeof(EntryHeader) + path.size() + 15) & ~static_cast<uint64_t>(15);
+    header.data_size = static_cast<uint64_t>(header.stride) * header.height;
+    
+    // Escritura atómica: archivo temporal + rename
+    std::string file_path = entry_path(path, info, width, height);
+    std::string tmp_path = file_path + ".tmp." + std::to_string(::getpid());
+    int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return;
+    }
+    
+    bool ok = write_all(fd, &header, sizeof(header)) && write_all(fd, path.data(), path.size());
+    std::vector<char> padding(header.data_offset - sizeof(EntryHeader) - path.size(), 0);
+    ok = ok && write_all(fd, padding.data(), padding.size());
+    
+    // Las filas del pixbuf pueden traer relleno (rowstride); guardar compactas
+    const guint8* pixels = pixbuf->get_pixels();
+    int rowstride = pixbuf->get_rowstride();
+    for (uint32_t row = 0; ok && row < header.height; ++row) {
+        ok = write_all(fd, pixels + static_cast<size_t>(row) * rowstride, header.stride);
+    }
+    ::close(fd);
+    
+    if (!ok || ::rename(tmp_path.c_str(), file_path.c_str()) != 0) {
+        std::cerr << "No se pudo guardar el fondo en caché: " << file_path << std::endl;
+        ::unlink(tmp_path.c_str());
+        return;
+    }
+    
+    evict();
+}
+
+void WallpaperCache::evict() {
+    struct Entry {
+        std::string path;
+        uint64_t size;
+        fs::file_time_type last_used;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    
+    std::error_code ec;
+    for (const auto& file : fs::directory_iterator(cache_dir_, ec)) {
+        if (file.path().extension() != ".px") {
+            continue;
+        }
+        std::error_code file_ec;
+        uint64_t size = file.file_size(file_ec);
+        auto last_used = file.last_write_time(file_ec);
+        if (file_ec) {
+            continue;
+        }
+        entries.push_back({file.path().string(), size, last_used});
+        total += size;
+    }
+    if (total <= max_bytes_) {
+        return;
+    }
+    
+    // Expulsar primero las usadas hace más tiempo
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.last_used < b.last_used;
+    });
+    for (const auto& entry : entries) {
+        if (total <= max_bytes_) {
+            break;
+        }
+        fs::remove(entry.path, ec);
+        total -= entry.size;
+    }
+}
@@ -0,0 +1,45 @@
+// WallpaperCache.hpp
+#pragma once
+#include <glibmm.h>
+#include <gdkmm/pixbuf.h>
+#include <cstdint>
+#include <string>
+
+// Caché en disco (~/.cache/entorno/wallpapers) de fondos ya escalados, en
+// píxeles sin comprimir. Las entradas se indexan por ruta de origen, mtime y
+// tamaño del monitor, y se leen con mmap para pasar directo a una textura.
+// El tamaño total está limitado; al superarlo se expulsan las entradas usadas
+// hace más tiempo (el mtime de cada entrada se actualiza en cada acierto).
+// Solo hace E/S de archivos, se puede usar desde el hilo de trabajo.
+class WallpaperCache {
+public:
+    struct Image {
+        Glib::RefPtr<Glib::Bytes> pixels;   // Memoria mapeada; se libera con munmap
+        int width = 0;
+        int height = 0;
+        size_t stride = 0;
+        bool has_alpha = false;
+    };
+
+    explicit WallpaperCache(uint64_t max_bytes = 256ull * 1024 * 1024);
+
+    // true si había una entrada válida para path al tamaño width x height
+    bool lookup(const std::string& path, int width, int height, Image& image);
+    void store(const std::string& path, int width, int height, const Glib::RefPtr<Gdk::Pixbuf>& pixbuf);
+
+    WallpaperCache(const WallpaperCache&) = delete;
+    WallpaperCache& operator=(const WallpaperCache&) = delete;
+
+private:
+    struct SourceInfo {
+        int64_t mtime_ns = 0;
+        uint64_t size = 0;
+    };
+
+    bool stat_source(const std::string& path, SourceInfo& info) const;
+    std::string entry_path(const std::string& path, const SourceInfo& info, int width, int height) const;
+    void evict();
+
+    std::string cache_dir_;
+    uint64_t max_bytes_;
+};
@@ -0,0 +1,160 @@
+// WallpaperLoader.cpp
+#include "WallpaperLoader.hpp"
+#include "../utils/WallpaperUtils.hpp"
+#include "../core/Tracer.hpp"
+#include <chrono>
+#include <iostream>
+
+WallpaperLoader::WallpaperLoader() {
+    result_ready_.open("wallpaper_decoded", [this](const Result& result) { on_result_ready(result); });
+    worker_ = std::thread(&WallpaperLoader::worker_loop, this);
+}
+
+WallpaperLoader::~WallpaperLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        jobs_.clear();
+    }
+    jobs_cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    result_ready_.close();
+    
+    for (auto& [key, weak] : live_textures_) {
+        g_weak_ref_clear(&weak);
+    }
+}
+
+size_t WallpaperLoader::get_texture_bytes() {
+    size_t bytes = 0;
+    for (auto& [key, weak] : live_textures_) {
+        GObject* object = static_cast<GObject*>(g_weak_ref_get(&weak));
+        if (object) {
+            GdkTexture* texture = GDK_TEXTURE(object);
+            bytes += static_cast<size_t>(gdk_texture_get_width(texture)) * gdk_texture_get_height(texture) * 4;
+            g_object_unref(object);
+        }
+    }
+    return bytes;
+}
+
+Glib::RefPtr<Gdk::Texture> WallpaperLoader::find_live_texture(const Key& key) {
+    // Limpiar de paso las texturas que ya nadie usa
+    Glib::RefPtr<Gdk::Texture> found;
+    for (auto it = live_textures_.begin(); it != live_textures_.end();) {
+        GObject* object = static_cast<GObject*>(g_weak_ref_get(&it->second));
+        if (!object) {
+            g_weak_ref_clear(&it->second);
+            it = live_textures_.erase(it);
+            continue;
+        }
+        if (it->first == key) {
+            found = Glib::wrap(GDK_TEXTURE(object)); // Toma la referencia de g_weak_ref_get
+        } else {
+            g_object_unref(object);
+        }
+        ++it;
+    }
+    return found;
+}
+
+void WallpaperLoader::request(const std::string& path, int width, int height, Callback callback) {
+    Key key{path, width, height};
+    
+    // Otra ventana del mismo tamaño ya muestra esta imagen: compartirla
+    if (auto texture = find_live_texture(key)) {
+        if (callback) {
+            callback(texture);
+        }
+        return;
+    }
+    
+    // Ya se está decodificando: esperar al mismo resultado
+    auto it = pending_.find(key);
+    if (it != pending_.end()) {
+        it->second.push_back(std::move(callback));
+        return;
+    }
+    pending_[key].push_back(std::move(callback));
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(key);
+    }
+    jobs_cv_.notify_one();
+}
+
+void WallpaperLoader::worker_loop() {
+    while (true) {
+        Key key;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobs_cv_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            key = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        
+        const auto& [path, width, height] = key;
+        Result result;
+        result.key = key;
+        
+        TraceSpan span("WallpaperLoader::decode");
+        auto start = std::chrono::steady_clock::now();
+        if (!cache_.lookup(path, width, height, result.cached)) {
+            try {
+                result.pixbuf = WallpaperUtils::load_scaled(path, width, height);
+                cache_.store(path, width, height, result.pixbuf);
+            } catch (const Glib::Error& ex) {
+                std::cerr << "Error loading wallpaper: " << ex.what() << std::endl;
+            }
+        }
+        result.decode_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+        }
+        // Varios resultados seguidos se entregan en el mismo lote del bucle principal
+        result_ready_.post(std::move(result));
+    }
+}
+
+void WallpaperLoader::on_result_ready(const Result& result) {
+    TraceSpan span("WallpaperLoader::upload");
+    Glib::RefPtr<Gdk::Texture> texture;
+    if (result.cached.pixels) {
+        // Píxeles mapeados desde la caché: la textura los usa sin copiarlos
+        auto format = result.cached.has_alpha ? Gdk::MemoryFormat::R8G8B8A8
+                                              : Gdk::MemoryFormat::R8G8B8;
+        texture = Gdk::MemoryTexture::create(result.cached.width, result.cached.height, format,
+                                             result.cached.pixels, result.cached.stride);
+    } else if (result.pixbuf) {
+        texture = Gdk::Texture::create_for_pixbuf(result.pixbuf);
+    }
+    
+    if (texture) {
+        std::cout << "Fondo " << (result.cached.pixels ? "leído de caché: " : "decodificado: ")
+                  << std::get<0>(result.key) << " (" << texture->get_width() << "x"
+                  << texture->get_height() << ", " << result.decode_ms << " ms)" << std::endl;
+        
+        // operator[] deja el GWeakRef a cero, válido para g_weak_ref_set
+        g_weak_ref_set(&live_textures_[result.key], texture->gobj());
+    }
+    
+    // Con textura nula el error ya se informó en el hilo de trabajo
+    auto callbacks = std::move(pending_[result.key]);
+    pending_.erase(result.key);
+    for (auto& callback : callbacks) {
+        if (callback) {
+            callback(texture);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+// WallpaperLoader.hpp
+#pragma once
+#include <gtkmm.h>
+#include "WallpaperCache.hpp"
+#include "../core/EventManager.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Decodifica y escala fondos en un hilo de trabajo. El resultado vuelve al
+// hilo principal, donde se crea la textura y se entrega al callback. Los
+// fondos ya escalados se guardan en WallpaperCache y en el siguiente inicio
+// se mapean desde disco sin decodificar.
+//
+// Las peticiones iguales (misma ruta y tamaño) se comparten: monitores del
+// mismo tamaño reciben la misma textura, decodificada una sola vez.
+class WallpaperLoader {
+public:
+    using Callback = std::function<void(const Glib::RefPtr<Gdk::Texture>& texture)>;
+
+    WallpaperLoader();
+    ~WallpaperLoader();
+
+    // width/height: tamaño en píxeles del monitor de destino. Si el archivo
+    // no se puede leer, el callback recibe una textura nula. Si la textura ya
+    // está en uso por otra ventana, el callback se llama inmediatamente.
+    void request(const std::string& path, int width, int height, Callback callback);
+
+    // Memoria de las texturas de fondo vivas (entregadas y aún en uso)
+    size_t get_texture_bytes();
+
+    WallpaperLoader(const WallpaperLoader&) = delete;
+    WallpaperLoader& operator=(const WallpaperLoader&) = delete;
+
+private:
+    using Key = std::tuple<std::string, int, int>;
+
+    // Llega al hilo principal por result_ready_
+    struct Result {
+        Key key;
+        Glib::RefPtr<Gdk::Pixbuf> pixbuf;       // Recién decodificado
+        WallpaperCache::Image cached;           // O leído de la caché
+        double decode_ms = 0;
+    };
+
+    void worker_loop();
+    void on_result_ready(const Result& result);
+    Glib::RefPtr<Gdk::Texture> find_live_texture(const Key& key);
+
+    // Hilo principal: peticiones en curso y texturas entregadas. Las texturas
+    // se guardan con GWeakRef, así no se retienen cuando nadie las muestra
+    std::map<Key, std::vector<Callback>> pending_;
+    std::map<Key, GWeakRef> live_textures_;
+
+    WallpaperCache cache_;      // Solo lo usa el hilo de trabajo
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable jobs_cv_;
+    std::deque<Key> jobs_;
+    bool stopping_ = false;
+    WorkerResults<Result> result_ready_;
+};
@@ -0,0 +1,231 @@
+// WallpaperSlideshow.cpp
+#include "WallpaperSlideshow.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool is_image(const fs::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".webp";
+}
+
+} // namespace
+
+WallpaperSlideshow::WallpaperSlideshow(WallpaperLoader& loader, const std::string& initial_wallpaper)
+    : loader_(loader), current_wallpaper_(initial_wallpaper), alive_(std::make_shared<bool>(true)) {}
+
+WallpaperSlideshow::~WallpaperSlideshow() {
+    stop();
+}
+
+void WallpaperSlideshow::add_window(WallpaperWindow& window) {
+    windows_.push_back(&window);
+    // La ventana nueva todavía no tiene su textura precargada
+    restart_prefetch();
+}
+
+void WallpaperSlideshow::remove_window(WallpaperWindow& window) {
+    windows_.erase(std::remove(windows_.begin(), windows_.end(), &window), windows_.end());
+    next_textures_.erase(&window);
+    
+    // Una ventana destruida nunca terminará su fundido
+    if (fading_.erase(&window) > 0 && fading_.empty()) {
+        prefetch();
+    }
+    if (prefetching_) {
+        restart_prefetch();
+    }
+}
+
+void WallpaperSlideshow::set_directory(const std::string& dir) {
+    images_.clear();
+    
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        if (entry.is_regular_file(ec) && is_image(entry.path())) {
+            images_.push_back(entry.path().string());
+        }
+    }
+    std::sort(images_.begin(), images_.end());
+    
+    if (ec) {
+        std::cerr << "No se pudo leer el directorio de fondos " << dir << ": " << ec.message() << std::endl;
+    }
+    
+    // Continuar desde el fondo que ya se está mostrando
+    current_index_ = 0;
+    fs::path current = fs::path(current_wallpaper_).lexically_normal();
+    for (size_t i = 0; i < images_.size(); ++i) {
+        if (fs::path(images_[i]).lexically_normal() == current) {
+            current_index_ = i;
+            break;
+        }
+    }
+    
+    std::cout << "Presentación de fondos: " << images_.size() << " imágenes en " << dir << std::endl;
+    restart_prefetch();
+}
+
+void WallpaperSlideshow::start(unsigned int interval_seconds) {
+    interval_seconds_ = interval_seconds;
+    timer_.disconnect();
+    timer_ = Glib::signal_timeout().connect_seconds(
+        sigc::mem_fun(*this, &WallpaperSlideshow::on_interval), interval_seconds
+    );
+}
+
+void WallpaperSlideshow::stop() {
+    timer_.disconnect();
+}
+
+const std::string& WallpaperSlideshow::get_current_wallpaper() const {
+    return current_wallpaper_;
+}
+
+void WallpaperSlideshow::next() {
+    if (images_.size() < 2) {
+        return;
+    }
+    
+    if (prefetch_ready_) {
+        show_prefetched();
+    } else {
+        // Se mostrará en cuanto termine la precarga; nunca se decodifica aquí
+        advance_pending_ = true;
+        prefetch();
+    }
+}
+
+void WallpaperSlideshow::set_current_wallpaper(const std::string& path) {
+    current_wallpaper_ = path;
+    fs::path current = fs::path(path).lexically_normal();
+    for (size_t i = 0; i < images_.size(); ++i) {
+        if (fs::path(images_[i]).lexically_normal() == current) {
+            current_index_ = i;
+            break;
+        }
+    }
+    
+    // Los fundidos cancelados no avisarán al terminar
+    fading_.clear();
+    advance_pending_ = false;
+    restart_prefetch();
+    
+    if (timer_.connected()) {
+        start(interval_seconds_);
+    }
+}
+
+bool WallpaperSlideshow::on_interval() {
+    next();
+    return true;
+}
+
+void WallpaperSlideshow::restart_prefetch() {
+    prefetch_generation_++;
+    next_textures_.clear();
+    prefetching_ = false;
+    prefetch_ready_ = false;
+    prefetch();
+}
+
+void WallpaperSlideshow::prefetch() {
+    // Durante un fundido ya hay dos texturas vivas; se precarga al terminar
+    if (prefetching_ || prefetch_ready_ || !fading_.empty() || images_.size() < 2 || windows_.empty()) {
+        return;
+    }
+    
+    size_t index = (current_index_ + 1) % images_.size();
+    uint64_t generation = ++prefetch_generation_;
+    prefetching_ = true;
+    prefetch_remaining_ = windows_.size();
+    next_index_ = index;
+    
+    // Monitores del mismo tamaño: el loader decodifica una vez y comparte
+    std::weak_ptr<bool> weak_alive = alive_;
+    auto windows = windows_;
+    for (auto* window : windows) {
+        int width = 0;
+        int height = 0;
+        window->get_target_size(width, height);
+        loader_.request(images_[index], width, height,
+            [this, weak_alive, window, generation, index](const Glib::RefPtr<Gdk::Texture>& texture) {
+                if (!weak_alive.expired()) {
+                    on_prefetched(window, generation, index, texture);
+                }
+            });
+        if (generation != prefetch_generation_) {
+            break; // La precarga se reinició desde un callback inmediato
+        }
+    }
+}
+
+void WallpaperSlideshow::on_prefetched(WallpaperWindow* window, uint64_t generation, size_t index,
+                                       const Glib::RefPtr<Gdk::Texture>& texture) {
+    if (generation != prefetch_generation_) {
+        return;
+    }
+    
+    // Imagen ilegible: sacarla de la rotación y probar con la siguiente
+    if (!texture) {
+        images_.erase(images_.begin() + index);
+        if (index < current_index_) {
+            current_index_--;
+        }
+        if (current_index_ >= images_.size()) {
+            current_index_ = 0;
+        }
+        restart_prefetch();
+        return;
+    }
+    
+    next_textures_[window] = texture;
+    if (--prefetch_remaining_ > 0) {
+        return;
+    }
+    
+    prefetching_ = false;
+    prefetch_ready_ = true;
+    if (advance_pending_) {
+        advance_pending_ = false;
+        show_prefetched();
+    }
+}
+
+void WallpaperSlideshow::show_prefetched() {
+    if (!prefetch_ready_ || !fading_.empty()) {
+        return;
+    }
+    
+    auto textures = std::move(next_textures_);
+    next_textures_.clear();
+    prefetch_ready_ = false;
+    current_index_ = next_index_;
+    current_wallpaper_ = images_[current_index_];
+    
+    std::weak_ptr<bool> weak_alive = alive_;
+    for (auto& [window, texture] : textures) {
+        fading_.insert(window);
+    }
+    for (auto& [window, texture] : textures) {
+        WallpaperWindow* faded = window;
+        window->crossfade_to(current_wallpaper_, texture, [this, weak_alive, faded]() {
+            if (!weak_alive.expired()) {
+                on_window_faded(faded);
+            }
+        });
+    }
+}
+
+void WallpaperSlideshow::on_window_faded(WallpaperWindow* window) {
+    if (fading_.erase(window) > 0 && fading_.empty()) {
+        prefetch();
+    }
+}
@@ -0,0 +1,74 @@
+// WallpaperSlideshow.hpp
+#pragma once
+#include <gtkmm.h>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "WallpaperLoader.hpp"
+#include "WallpaperWindow.hpp"
+
+// Rotación de fondos: recorre las imágenes de un directorio cada cierto
+// intervalo en todas las ventanas de fondo (una por monitor). La siguiente
+// imagen se decodifica por adelantado en el hilo del WallpaperLoader, de modo
+// que el cambio es solo un fundido entre texturas. Por monitor hay como mucho
+// dos texturas de pantalla completa vivas: la actual y la siguiente; los
+// monitores del mismo tamaño comparten las mismas texturas.
+class WallpaperSlideshow {
+public:
+    WallpaperSlideshow(WallpaperLoader& loader, const std::string& initial_wallpaper);
+    ~WallpaperSlideshow();
+
+    void add_window(WallpaperWindow& window);
+    void remove_window(WallpaperWindow& window);
+
+    // Busca imágenes (jpg, jpeg, png, webp) en dir, en orden alfabético
+    void set_directory(const std::string& dir);
+
+    void start(unsigned int interval_seconds);
+    void stop();
+
+    // Pasar a la siguiente imagen ya (p. ej. desde el menú contextual)
+    void next();
+
+    // Fondo elegido a mano (ya cargado en las ventanas, que cancelan su
+    // fundido): la rotación sigue desde él y el intervalo vuelve a empezar
+    void set_current_wallpaper(const std::string& path);
+
+    // Imagen que se muestra ahora (para ventanas de monitores nuevos)
+    const std::string& get_current_wallpaper() const;
+
+    WallpaperSlideshow(const WallpaperSlideshow&) = delete;
+    WallpaperSlideshow& operator=(const WallpaperSlideshow&) = delete;
+
+private:
+    void restart_prefetch();
+    void prefetch();
+    void on_prefetched(WallpaperWindow* window, uint64_t generation, size_t index,
+                       const Glib::RefPtr<Gdk::Texture>& texture);
+    void show_prefetched();
+    void on_window_faded(WallpaperWindow* window);
+    bool on_interval();
+
+    WallpaperLoader& loader_;
+    std::vector<WallpaperWindow*> windows_;     // Propiedad de CoreSystem
+    std::vector<std::string> images_;
+    size_t current_index_ = 0;
+    std::string current_wallpaper_;
+
+    // Precarga de la siguiente imagen, una textura por ventana
+    std::map<WallpaperWindow*, Glib::RefPtr<Gdk::Texture>> next_textures_;
+    size_t next_index_ = 0;
+    size_t prefetch_remaining_ = 0;
+    uint64_t prefetch_generation_ = 0;      // Invalida precargas obsoletas
+    bool prefetching_ = false;
+    bool prefetch_ready_ = false;
+    bool advance_pending_ = false;          // next() pedido antes de que la precarga terminara
+
+    std::set<WallpaperWindow*> fading_;     // Ventanas con el fundido en curso
+
+    sigc::connection timer_;
+    unsigned int interval_seconds_ = 0;
+    std::shared_ptr<bool> alive_;
+};
@@ -1,78 +1,165 @@
 //WallpaperWindow.cpp
 #include "WallpaperWindow.hpp"
-#include "../core/EventManager.hpp"
-#include "../config/ThemeManager.hpp"
+#include "../core/Events.hpp"
+#include <gdkmm/monitor.h>
 #include <iostream>
 
 
 
-WallpaperWindow::WallpaperWindow(const std::string& wallpaper_path) 
-    : current_wallpaper(wallpaper_path) {
+WallpaperWindow::WallpaperWindow(const std::string& wallpaper_path, WallpaperLoader& loader,
+                                 const Glib::RefPtr<Gdk::Monitor>& monitor) 
+    : current_wallpaper(wallpaper_path), loader(loader), monitor(monitor),
+      alive(std::make_shared<bool>(true)) {
 
     set_decorated(false);
-    get_style_context()->add_class("wallpaper-window");
+    add_css_class("wallpaper-window");
     set_resizable(false);
     set_title("Fondo de escritorio");
-    fullscreen();
+    if (monitor) {
+        fullscreen_on_monitor(monitor);
+    } else {
+        fullscreen();
+    }
 
-    // Eliminado: ThemeManager local redundante
-    // El tema se aplicará externamente via apply_theme()
+    // Mientras se decodifica se ve el color de fondo del tema (.wallpaper-window)
+    image.set_content_fit(Gtk::ContentFit::COVER);
+    incoming_image.set_content_fit(Gtk::ContentFit::COVER);
+    incoming_image.set_can_target(false);
+    incoming_image.set_opacity(0.0);
     
-    try {
-        image.set_filename(current_wallpaper);
-        image.set_content_fit(Gtk::ContentFit::COVER);
-    }
-    catch (const Glib::Error& ex) {
-        std::cerr << "Error loading wallpaper: " << ex.what() << std::endl;
+    // La imagen entrante se superpone a la actual durante el fundido
+    overlay.set_child(image);
+    overlay.add_overlay(incoming_image);
+    set_child(overlay);
+    setup_event_listeners();
+    
+    load_wallpaper(current_wallpaper);
+}
+
+void WallpaperWindow::get_target_size(int& width, int& height) const {
+    // Decodificar al tamaño real del monitor, no a la resolución del archivo
+    width = 1920;
+    height = 1080;
+    if (monitor) {
+        Gdk::Rectangle geometry;
+        monitor->get_geometry(geometry);
+        width = geometry.get_width() * monitor->get_scale_factor();
+        height = geometry.get_height() * monitor->get_scale_factor();
     }
+}
+
+void WallpaperWindow::load_wallpaper(const std::string& path) {
+    // Si no, al terminar el fundido la imagen entrante taparía la elegida
+    cancel_crossfade();
+    current_wallpaper = path;
     
-    set_child(image);
-    setup_event_listeners();
+    int width = 0;
+    int height = 0;
+    get_target_size(width, height);
+    
+    std::weak_ptr<bool> weak_alive = alive;
+    loader.request(path, width, height, [this, weak_alive, path](const Glib::RefPtr<Gdk::Texture>& texture) {
+        // Ignorar resultados de una ventana destruida o de un fondo ya reemplazado
+        if (weak_alive.expired() || !texture || path != current_wallpaper) {
+            return;
+        }
+        image.set_paintable(texture);
+    });
 }
 
-WallpaperWindow::~WallpaperWindow() {
-    // Desconectar todas las señales y gestos
-    if (right_click_gesture) {
-        remove_controller(right_click_gesture);
-        right_click_gesture.reset();
+void WallpaperWindow::crossfade_to(const std::string& path, const Glib::RefPtr<Gdk::Texture>& texture,
+                                   std::function<void()> on_finished) {
+    // Un fundido anterior sin terminar se completa de golpe
+    if (fade_tick_id != 0) {
+        finish_crossfade();
     }
     
+    current_wallpaper = path;
+    fade_finished = std::move(on_finished);
+    incoming_image.set_paintable(texture);
+    incoming_image.set_opacity(0.0);
+    fade_start_time = 0;
+    fade_tick_id = add_tick_callback(sigc::mem_fun(*this, &WallpaperWindow::on_fade_tick));
 }
 
-void WallpaperWindow::apply_theme(ThemeManager* theme) {
-    auto context = get_style_context();
+bool WallpaperWindow::on_fade_tick(const Glib::RefPtr<Gdk::FrameClock>& frame_clock) {
+    // Avance según el reloj de frames: un paso por frame pintado
+    gint64 now = frame_clock->get_frame_time();
+    if (fade_start_time == 0) {
+        fade_start_time = now;
+    }
+    
+    double progress = static_cast<double>(now - fade_start_time) / FADE_DURATION_US;
+    if (progress >= 1.0) {
+        fade_tick_id = 0;
+        finish_crossfade();
+        return false;
+    }
     
-    // Limpiar proveedor anterior
-    if (current_provider) {
-        context->remove_provider(current_provider);
+    // Curva suave (ease-in-out)
+    incoming_image.set_opacity(progress * progress * (3.0 - 2.0 * progress));
+    return true;
+}
+
+void WallpaperWindow::finish_crossfade() {
+    if (fade_tick_id != 0) {
+        remove_tick_callback(fade_tick_id);
+        fade_tick_id = 0;
     }
     
-    // Obtener el proveedor específico para este componente
-    current_provider = theme->get_component_provider("wallpaper-window");
-    if (current_provider) {
-        context->add_provider(current_provider, GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+    // La entrante pasa a ser la actual y se suelta la anterior: nunca hay
+    // más de dos texturas de pantalla completa vivas
+    image.set_paintable(incoming_image.get_paintable());
+    incoming_image.set_paintable(nullptr);
+    incoming_image.set_opacity(0.0);
+    
+    if (fade_finished) {
+        auto callback = std::move(fade_finished);
+        fade_finished = nullptr;
+        callback();
+    }
+}
+
+void WallpaperWindow::cancel_crossfade() {
+    if (fade_tick_id != 0) {
+        remove_tick_callback(fade_tick_id);
+        fade_tick_id = 0;
+    }
+    incoming_image.set_paintable(nullptr);
+    incoming_image.set_opacity(0.0);
+    // Sin avisar: quien lo pidió (la presentación) ya sabe del cambio manual
+    fade_finished = nullptr;
+}
+
+WallpaperWindow::~WallpaperWindow() {
+    refresh_connection.disconnect();
+    if (fade_tick_id != 0) {
+        remove_tick_callback(fade_tick_id);
     }
+
+    // Desconectar todas las señales y gestos
+    if (right_click_gesture) {
+        remove_controller(right_click_gesture);
+        right_click_gesture.reset();
+    }
+    
 }
 
 void WallpaperWindow::on_right_click_pressed(int n_press, double x, double y) {
     std::cout << "Clic derecho detectado en posición: " << x << ", " << y << std::endl;
-    EventManager::get_instance().trigger_event("desktop_right_click");
+    EventManager::get_instance().emit(Events::desktop_right_click(), PointerEvent{x, y, this});
 }
 
 void WallpaperWindow::refresh_desktop() {
-    // Crear efecto de parpadeo
-    auto css_provider = Gtk::CssProvider::create();
-    css_provider->load_from_data(".wallpaper-window { opacity: 0.5; }");
-    
-    auto style_context = get_style_context();
-    style_context->add_provider(css_provider, GTK_STYLE_PROVIDER_PRIORITY_USER);
-    queue_draw();
+    // Crear efecto de parpadeo con la clase .refreshing de wallpaper.css
+    add_css_class("refreshing");
 
     // Guardamos la conexión para poder desconectarla si hace falta
-    Glib::signal_timeout().connect_once(
-        [this, css_provider]() {
-            this->get_style_context()->remove_provider(css_provider);
-            this->queue_draw();
+    refresh_connection.disconnect();
+    refresh_connection = Glib::signal_timeout().connect(
+        [this]() {
+            this->remove_css_class("refreshing");
+            return false;
         },
         100
     );
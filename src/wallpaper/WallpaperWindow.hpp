@@ -1,27 +1,52 @@
 // WallpaperWindow.hpp
 #pragma once
 #include <gtkmm.h>
-#include "../config/ThemeManager.hpp"
+#include "WallpaperLoader.hpp"
 #include <gdkmm/event.h>
+#include <functional>
 #include <memory> // Para weak_ptr
 
 class WallpaperWindow : public Gtk::Window {
 public:
-    WallpaperWindow(const std::string& wallpaper_path);
+    WallpaperWindow(const std::string& wallpaper_path, WallpaperLoader& loader,
+                    const Glib::RefPtr<Gdk::Monitor>& monitor);
     ~WallpaperWindow(); // Destructor añadido
     
-    void apply_theme(ThemeManager* theme);
     void setup_event_listeners();
     void refresh_desktop(); 
+    // Cancela un fundido en curso: la imagen entrante no llega a mostrarse
+    void load_wallpaper(const std::string& path);
+
+    // Fundido hacia una textura ya decodificada, guiado por el reloj de frames
+    void crossfade_to(const std::string& path, const Glib::RefPtr<Gdk::Texture>& texture,
+                      std::function<void()> on_finished = nullptr);
+
+    // Tamaño en píxeles al que se deben decodificar los fondos
+    void get_target_size(int& width, int& height) const;
+    const std::string& get_current_wallpaper() const { return current_wallpaper; }
+    Glib::RefPtr<Gdk::Monitor> get_monitor() const { return monitor; }
 
 private:
-    Gtk::Picture image;
+    static constexpr gint64 FADE_DURATION_US = 800000;
+
+    Gtk::Overlay overlay;
+    Gtk::Picture image;             // Fondo actual
+    Gtk::Picture incoming_image;    // Fondo entrante durante el fundido
     std::string current_wallpaper;
-    Glib::RefPtr<Gtk::CssProvider> current_provider;
+    WallpaperLoader& loader;        // Compartido, propiedad de CoreSystem
+    Glib::RefPtr<Gdk::Monitor> monitor;
+    std::shared_ptr<bool> alive;    // Los callbacks del loader comprueban que la ventana sigue viva
+
+    guint fade_tick_id = 0;
+    gint64 fade_start_time = 0;
+    std::function<void()> fade_finished;
 
     // Gestos y señales
     Glib::RefPtr<Gtk::GestureClick> right_click_gesture;
-    // sigc::connection refresh_connection; // Conexión para efecto de refresco
+    sigc::connection refresh_connection; // Conexión para efecto de refresco
     
     void on_right_click_pressed(int n_press, double x, double y);
+    bool on_fade_tick(const Glib::RefPtr<Gdk::FrameClock>& frame_clock);
+    void finish_crossfade();
+    void cancel_crossfade();
 };
\ No newline at end of file
@@ -0,0 +1,84 @@
+// ThemeSnapshotTest.cpp
+// Recarga de un tema en la que cambia una variable global y, a la vez, el
+// archivo CSS de un componente que la usa no se puede leer (p. ej. a medio
+// guardar): el componente debe conservar su plantilla anterior pero
+// renderizada con el valor nuevo, y aparecer en changed_components.
+//
+//   make test && ./build/tests/theme_snapshot
+#include "../src/config/ThemeSnapshot.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FALLO: %s\n", what);
+        ++failures;
+    }
+}
+
+void write_file(const std::filesystem::path& path, const std::string& content) {
+    std::ofstream file(path);
+    file << content;
+}
+
+void write_theme(const std::filesystem::path& dir, const std::string& accent) {
+    write_file(dir / "theme.json",
+               "{\"global\": {\"accent\": \"" + accent + "\", \"bg\": \"#000000\"},"
+               " \"components\": {\"panel\": \"panel.css\", \"dock\": \"dock.css\"}}");
+}
+
+bool changed(const ThemeSnapshot& snapshot, const std::string& name) {
+    const auto& names = snapshot.changed_components;
+    return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+} // namespace
+
+int main() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "entorno-theme-snapshot-test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    write_theme(dir, "#ff0000");
+    write_file(dir / "panel.css", "box { color: var(--accent); }\n");
+    write_file(dir / "dock.css", "box { background: var(--bg); }\n");
+
+    CSSTemplateCache cache;
+    CSSParser parser;
+    auto first = ThemeSnapshot::load(dir.string(), cache, parser);
+    check(first != nullptr, "el primer tema se carga");
+    if (!first) {
+        return 1;
+    }
+    const auto* panel = first->find_component("panel");
+    check(panel && panel->css.find("#ff0000") != std::string::npos, "panel usa el acento inicial");
+
+    // Cambia --accent y panel.css desaparece a medio guardar
+    write_theme(dir, "#00ff00");
+    std::filesystem::remove(dir / "panel.css");
+    cache.invalidate((dir / "panel.css").string());
+
+    auto second = ThemeSnapshot::load(dir.string(), cache, parser, first.get());
+    check(second != nullptr, "el tema se recarga aunque panel.css no se pueda leer");
+    if (second) {
+        panel = second->find_component("panel");
+        check(panel && panel->css.find("#00ff00") != std::string::npos, "panel usa el acento nuevo");
+        check(panel && panel->css.find("#ff0000") == std::string::npos, "panel no conserva el acento viejo");
+        check(changed(*second, "panel"), "panel figura en changed_components");
+        check(!changed(*second, "dock"), "dock no cambia");
+        const auto* dock = second->find_component("dock");
+        check(dock && dock->css == first->find_component("dock")->css, "dock reutiliza su CSS");
+    }
+
+    std::filesystem::remove_all(dir);
+    if (failures == 0) {
+        std::printf("ThemeSnapshot: OK\n");
+    }
+    return failures == 0 ? 0 : 1;
+}